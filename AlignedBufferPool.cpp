@@ -0,0 +1,125 @@
+#include "AlignedBufferPool.h"
+#include <new>
+
+
+static char* AllocateAligned(size_t size)
+{
+    return static_cast<char*>(::operator new(size, std::align_val_t(AlignedBufferPool::Alignment)));
+}
+
+static void FreeAligned(char* data)
+{
+    ::operator delete(data, std::align_val_t(AlignedBufferPool::Alignment));
+}
+
+
+/// <summary>
+/// Creates an empty pool, buffers are allocated on demand
+/// </summary>
+/// <param name="bufferSize">The size of every buffer, rounded up to a multiple of Alignment</param>
+/// <param name="maxIdleBuffers">The number of returned buffers kept for reuse, more are freed</param>
+AlignedBufferPool::AlignedBufferPool(size_t bufferSize, size_t maxIdleBuffers)
+    : bufferSize((bufferSize + Alignment - 1) / Alignment * Alignment), maxIdleBuffers(maxIdleBuffers)
+{
+    if (this->bufferSize == 0)
+        this->bufferSize = Alignment;
+}
+
+/// <summary>
+/// Frees the idle buffers. All borrowed buffers must have been returned before.
+/// </summary>
+AlignedBufferPool::~AlignedBufferPool()
+{
+    for (char* data : idle)
+        FreeAligned(data);
+}
+
+/// <summary>
+/// The pool used by the library functions, with buffers of DefaultBufferSize
+/// </summary>
+AlignedBufferPool& AlignedBufferPool::GetShared()
+{
+    static AlignedBufferPool shared;
+    return shared;
+}
+
+/// <summary>
+/// Borrows a buffer, reusing an idle one if there is any
+/// </summary>
+/// <returns>The buffer, with GetBufferSize bytes aligned to Alignment. Its content is undefined</returns>
+AlignedBufferPool::Buffer AlignedBufferPool::Acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!idle.empty())
+        {
+            char* data = idle.back();
+            idle.pop_back();
+            return Buffer(this, data, bufferSize);
+        }
+    }
+
+    return Buffer(this, AllocateAligned(bufferSize), bufferSize);
+}
+
+size_t AlignedBufferPool::GetBufferSize() const
+{
+    return bufferSize;
+}
+
+/// <summary>
+/// The number of buffers waiting for reuse
+/// </summary>
+size_t AlignedBufferPool::GetIdleBufferCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return idle.size();
+}
+
+void AlignedBufferPool::Release(char* data)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (idle.size() < maxIdleBuffers)
+        {
+            idle.push_back(data);
+            return;
+        }
+    }
+
+    FreeAligned(data);
+}
+
+
+AlignedBufferPool::Buffer::Buffer(AlignedBufferPool* pool, char* data, size_t size)
+    : pool(pool), data(data), size(size)
+{
+}
+
+AlignedBufferPool::Buffer::Buffer(Buffer&& other) noexcept
+    : pool(other.pool), data(other.data), size(other.size)
+{
+    other.data = nullptr;
+}
+
+AlignedBufferPool::Buffer& AlignedBufferPool::Buffer::operator=(Buffer&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (data)
+            pool->Release(data);
+
+        pool = other.pool;
+        data = other.data;
+        size = other.size;
+        other.data = nullptr;
+    }
+
+    return *this;
+}
+
+AlignedBufferPool::Buffer::~Buffer()
+{
+    if (data)
+        pool->Release(data);
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+
+// A pool of reusable memory blocks aligned for direct IO (O_DIRECT), used by the FileIOOptions::directIO paths.
+// Direct IO needs the memory address, file offset and length of every transfer aligned to the logical block size
+// of the device. Alignment covers all common devices. Allocating such blocks for every call is expensive,
+// so finished transfers return their buffers to the pool and the next transfer picks them up again.
+//
+// Thread safety: all public functions may be called concurrently from any thread. A Buffer belongs to one thread at a time.
+
+class AlignedBufferPool
+{
+public:
+    class Buffer;
+
+    static constexpr size_t Alignment = 4096;
+    static constexpr size_t DefaultBufferSize = 1024 * 1024;
+
+    explicit AlignedBufferPool(size_t bufferSize = DefaultBufferSize, size_t maxIdleBuffers = 16);
+    ~AlignedBufferPool();
+
+    AlignedBufferPool(const AlignedBufferPool&) = delete;
+    AlignedBufferPool& operator=(const AlignedBufferPool&) = delete;
+
+    static AlignedBufferPool& GetShared();
+
+    Buffer Acquire();
+    size_t GetBufferSize() const;
+    size_t GetIdleBufferCount();
+
+private:
+    void Release(char* data);
+
+    size_t bufferSize;
+    size_t maxIdleBuffers;      // Buffers beyond this are freed when they come back, instead of being kept around
+    std::mutex mutex;
+    std::vector<char*> idle;
+};
+
+
+// A buffer borrowed from an AlignedBufferPool, given back to the pool when it is destroyed
+class AlignedBufferPool::Buffer
+{
+public:
+    Buffer(Buffer&& other) noexcept;
+    Buffer& operator=(Buffer&& other) noexcept;
+    ~Buffer();
+
+    char* GetData() const { return data; }
+    size_t GetSize() const { return size; }
+
+private:
+    friend class AlignedBufferPool;
+    Buffer(AlignedBufferPool* pool, char* data, size_t size);
+
+    AlignedBufferPool* pool;
+    char* data;
+    size_t size;
+};
@@ -0,0 +1,192 @@
+#include "BatchOps.h"
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+
+/// <summary>
+/// Creates the batch runner and its thread pool
+/// </summary>
+/// <param name="threadCount">The number of worker threads, 0 uses the number of hardware threads</param>
+BatchOps::BatchOps(unsigned int threadCount) : pool(threadCount)
+{
+}
+
+/// <summary>
+/// Runs all operations of the batch and waits until they have finished
+/// </summary>
+/// <param name="operations">The operations to run</param>
+/// <returns>One result per operation, in the same order as the operations. True if the operation succeeded, false if it failed</returns>
+std::vector<bool> BatchOps::Run(const std::vector<Operation>& operations)
+{
+    // std::vector<bool> packs bits and can not be written from multiple threads, collect into chars first
+    std::vector<char> results(operations.size(), 0);
+
+    {
+        ThreadPool::TaskGroup group(pool);
+
+        for (auto& chain : BuildOrderedChains(operations))
+        {
+            group.Run([&operations, &results, chain = std::move(chain)]()
+            {
+                for (size_t index : chain)
+                    results[index] = Execute(operations[index]) ? 1 : 0;
+            });
+        }
+
+        group.Wait();
+    }
+
+    return std::vector<bool>(results.begin(), results.end());
+}
+
+/// <summary>
+/// Get the number of worker threads
+/// </summary>
+/// <returns>The number of worker threads used to run the batches</returns>
+unsigned int BatchOps::GetThreadCount() const
+{
+    return pool.GetThreadCount();
+}
+
+bool BatchOps::Execute(const Operation& operation)
+{
+    try
+    {
+        switch (operation.type)
+        {
+        case OperationType::MoveFile:     return FileUtils::MoveFile(operation.source, operation.destination);
+        case OperationType::MoveFolder:   return FileUtils::MoveFolder(operation.source, operation.destination);
+        case OperationType::CopyFile:     return FileUtils::CopyFile(operation.source, operation.destination);
+        case OperationType::CopyFolder:   return FileUtils::CopyFolder(operation.source, operation.destination);
+        case OperationType::RenameFile:   return FileUtils::RenameFile(operation.source, operation.destination);
+        case OperationType::RenameFolder: return FileUtils::RenameFolder(operation.source, operation.destination);
+        case OperationType::DeleteFile:   return FileUtils::DeleteFile(operation.source);
+        case OperationType::DeleteFolder: return FileUtils::DeleteFolder(operation.source);
+        }
+    }
+
+    catch (...)
+    {
+        return false;
+    }
+
+    return false;
+}
+
+/// <summary>
+/// Get the paths an operation reads or writes
+/// </summary>
+std::vector<std::filesystem::path> BatchOps::GetTouchedPaths(const Operation& operation)
+{
+    switch (operation.type)
+    {
+    case OperationType::DeleteFile:
+    case OperationType::DeleteFolder:
+        return { operation.source };
+
+    case OperationType::MoveFolder:
+    {
+        // MoveFolder takes the containing folder as destination, the folder itself ends up below it
+        std::filesystem::path source = operation.source;
+        if (!source.has_filename())
+            source = source.parent_path();
+        return { operation.source, operation.destination / source.filename() };
+    }
+
+    default:
+        return { operation.source, operation.destination };
+    }
+}
+
+/// <summary>
+/// Builds the lexical key under which a path is compared against the paths of other operations
+/// </summary>
+std::filesystem::path BatchOps::GetOrderingKey(const std::filesystem::path& path)
+{
+    std::error_code error;
+    std::filesystem::path key = std::filesystem::absolute(path, error);
+    if (error)
+        key = path;
+
+    key = key.lexically_normal();
+    if (!key.has_filename() && key.has_relative_path())
+        key = key.parent_path();
+
+    return key;
+}
+
+/// <summary>
+/// Splits the batch into chains of operations which have to run in order. Chains are independent of each other.
+/// </summary>
+/// <param name="operations">The operations of the batch</param>
+/// <returns>The chains, each one holding the operation indices in batch order</returns>
+std::vector<std::vector<size_t>> BatchOps::BuildOrderedChains(const std::vector<Operation>& operations)
+{
+    std::vector<size_t> parents(operations.size());
+    std::iota(parents.begin(), parents.end(), 0);
+
+    auto findRoot = [&parents](size_t index)
+    {
+        while (parents[index] != index)
+        {
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+        }
+        return index;
+    };
+
+    auto join = [&](size_t a, size_t b)
+    {
+        a = findRoot(a);
+        b = findRoot(b);
+        if (a != b)
+            parents[std::max(a, b)] = std::min(a, b);
+    };
+
+    // Operations on the same path
+    std::unordered_map<std::string, size_t> owners;
+    std::vector<std::vector<std::filesystem::path>> touchedPaths(operations.size());
+
+    for (size_t i = 0; i < operations.size(); i++)
+    {
+        for (auto& path : GetTouchedPaths(operations[i]))
+        {
+            std::filesystem::path key = GetOrderingKey(path);
+            auto inserted = owners.emplace(key.string(), i);
+            if (!inserted.second)
+                join(inserted.first->second, i);
+
+            touchedPaths[i].push_back(std::move(key));
+        }
+    }
+
+    // Operations inside of a folder that another operation works on
+    for (size_t i = 0; i < operations.size(); i++)
+    {
+        for (auto& path : touchedPaths[i])
+        {
+            std::filesystem::path child = path;
+            for (std::filesystem::path parent = child.parent_path(); !parent.empty() && parent != child; child = parent, parent = parent.parent_path())
+            {
+                auto owner = owners.find(parent.string());
+                if (owner != owners.end())
+                    join(owner->second, i);
+            }
+        }
+    }
+
+    std::vector<std::vector<size_t>> chains;
+    std::unordered_map<size_t, size_t> chainOfRoot;
+
+    for (size_t i = 0; i < operations.size(); i++)
+    {
+        auto inserted = chainOfRoot.emplace(findRoot(i), chains.size());
+        if (inserted.second)
+            chains.emplace_back();
+
+        chains[inserted.first->second].push_back(i);
+    }
+
+    return chains;
+}
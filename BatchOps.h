@@ -0,0 +1,50 @@
+#pragma once
+#include "FileUtils.h"
+#include "ThreadPool.h"
+
+
+// Batch file/folder operations. Runs a list of move, copy, rename and delete operations on a work-stealing thread pool
+// instead of calling the FileUtils functions one after another. Every operation behaves exactly like its FileUtils counterpart.
+//
+// Ordering: operations which touch the same path, or where one operation works on a folder that contains the path of another
+// operation, are run one after another in the order in which they appear in the batch. All other operations may run in parallel.
+// Paths are compared lexically, links are not resolved.
+//
+// Thread safety: Run() may be called concurrently from multiple threads on the same BatchOps instance, all batches share the pool.
+// The ordering guarantee only applies within one batch, operations of concurrently running batches are not ordered against each other.
+
+class BatchOps
+{
+public:
+    enum class OperationType
+    {
+        MoveFile,
+        MoveFolder,
+        CopyFile,
+        CopyFolder,
+        RenameFile,
+        RenameFolder,
+        DeleteFile,
+        DeleteFolder
+    };
+
+    struct Operation
+    {
+        OperationType type;
+        std::filesystem::path source;
+        std::filesystem::path destination; // Unused for delete operations
+    };
+
+    explicit BatchOps(unsigned int threadCount = 0);
+
+    std::vector<bool> Run(const std::vector<Operation>& operations);
+    unsigned int GetThreadCount() const;
+
+private:
+    static bool Execute(const Operation& operation);
+    static std::vector<std::filesystem::path> GetTouchedPaths(const Operation& operation);
+    static std::filesystem::path GetOrderingKey(const std::filesystem::path& path);
+    static std::vector<std::vector<size_t>> BuildOrderedChains(const std::vector<Operation>& operations);
+
+    ThreadPool pool;
+};
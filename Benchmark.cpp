@@ -0,0 +1,499 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+
+
+// Global allocation counters, every operator new of the process goes through here
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // False positive for replaced global operators backed by malloc/free
+#endif
+
+static std::atomic<uint64_t> allocationCount{ 0 };
+static std::atomic<uint64_t> allocationBytes{ 0 };
+
+void* operator new(size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	allocationBytes.fetch_add(size, std::memory_order_relaxed);
+
+	if (void* memory = std::malloc(size == 0 ? 1 : size))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+
+void Benchmark::Log(std::string message)
+{
+	std::cerr << message << std::endl;
+}
+
+template <typename Operation>
+void Benchmark::Measure(std::string name, size_t count, uint64_t bytesPerOperation, Operation operation)
+{
+	Result result;
+	result.name = name;
+	result.operations = count;
+	result.latenciesNs.reserve(count);
+
+	uint64_t allocationsBefore = allocationCount.load();
+	uint64_t allocatedBytesBefore = allocationBytes.load();
+	auto start = std::chrono::steady_clock::now();
+
+	for (size_t i = 0; i < count; i++)
+	{
+		auto operationStart = std::chrono::steady_clock::now();
+		bool success = operation(i);
+		auto operationEnd = std::chrono::steady_clock::now();
+
+		result.latenciesNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(operationEnd - operationStart).count());
+		if (!success)
+			result.failures++;
+	}
+
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	// The latency vector was reserved up front, so the harness itself does not allocate inside the loop
+	result.allocations = allocationCount.load() - allocationsBefore;
+	result.allocatedBytes = allocationBytes.load() - allocatedBytesBefore;
+	result.bytes = bytesPerOperation * count;
+
+	std::sort(result.latenciesNs.begin(), result.latenciesNs.end());
+	Log(name + ": " + std::to_string(count) + " ops in " + std::to_string(result.seconds) + "s" + (result.failures ? ", " + std::to_string(result.failures) + " FAILED" : ""));
+	results.push_back(std::move(result));
+}
+
+std::filesystem::path Benchmark::GetTreeFile(std::filesystem::path treePath, size_t index)
+{
+	return treePath / ("folder" + std::to_string(index % options.folderCount)) / ("file_" + std::to_string(index) + ".bin");
+}
+
+void Benchmark::CreateTree(std::filesystem::path treePath)
+{
+	for (int i = 0; i < options.folderCount; i++)
+		FileUtils::CreateNewFolder(treePath / ("folder" + std::to_string(i)));
+
+	for (int i = 0; i < options.fileCount; i++)
+		FileUtils::WriteBinaryFile(GetTreeFile(treePath, i), payload.data(), (int)payload.size());
+}
+
+void Benchmark::BenchmarkFileIO()
+{
+	std::filesystem::path ioPath = options.root / "IO";
+	FileUtils::CreateNewFolder(ioPath);
+	size_t count = options.fileCount;
+
+	Measure("WriteBinaryFile", count, payload.size(), [&](size_t i)
+	{
+		return FileUtils::WriteBinaryFile(ioPath / ("file_" + std::to_string(i) + ".bin"), payload.data(), (int)payload.size());
+	});
+
+	Measure("ReadBinaryFile", count, payload.size(), [&](size_t i)
+	{
+		char* buffer = FileUtils::ReadBinaryFile(ioPath / ("file_" + std::to_string(i) + ".bin"));
+		delete[] buffer;
+		return buffer != nullptr;
+	});
+
+	// Mostly zeros, only the first block holds data, like the files of a sparse volume cache
+	std::vector<char> sparsePayload(payload.size(), 0);
+	std::copy(payload.begin(), payload.begin() + std::min<size_t>(payload.size(), 4096), sparsePayload.begin());
+	FileIOOptions sparse;
+	sparse.sparse = true;
+
+	Measure("WriteBinaryFile (sparse)", count, payload.size(), [&](size_t i)
+	{
+		return FileUtils::WriteBinaryFile(ioPath / ("sparse_" + std::to_string(i) + ".bin"), sparsePayload.data(), sparsePayload.size(), sparse);
+	});
+
+	Measure("ReadBinaryFile (sparse)", count, payload.size(), [&](size_t i)
+	{
+		char* buffer = FileUtils::ReadBinaryFile(ioPath / ("sparse_" + std::to_string(i) + ".bin"), sparse);
+		delete[] buffer;
+		return buffer != nullptr;
+	});
+
+	Measure("CopyFile (sparse)", count, payload.size(), [&](size_t i)
+	{
+		return FileUtils::CopyFile(ioPath / ("sparse_" + std::to_string(i) + ".bin"), ioPath / ("sparse_copy_" + std::to_string(i) + ".bin"), sparse);
+	});
+
+	FileIOOptions direct;
+	direct.directIO = true;
+
+	Measure("WriteBinaryFile (direct)", count, payload.size(), [&](size_t i)
+	{
+		return FileUtils::WriteBinaryFile(ioPath / ("direct_" + std::to_string(i) + ".bin"), payload.data(), payload.size(), direct);
+	});
+
+	Measure("ReadBinaryFile (direct)", count, payload.size(), [&](size_t i)
+	{
+		char* buffer = FileUtils::ReadBinaryFile(ioPath / ("direct_" + std::to_string(i) + ".bin"), direct);
+		delete[] buffer;
+		return buffer != nullptr;
+	});
+
+	Measure("CopyFile (direct)", count, payload.size(), [&](size_t i)
+	{
+		return FileUtils::CopyFile(ioPath / ("direct_" + std::to_string(i) + ".bin"), ioPath / ("direct_copy_" + std::to_string(i) + ".bin"), direct);
+	});
+
+	std::string text(payload.size(), 'a');
+
+	Measure("WriteTextFile", count, text.size(), [&](size_t i)
+	{
+		return FileUtils::WriteTextFile(ioPath / ("file_" + std::to_string(i) + ".txt"), text);
+	});
+
+	Measure("ReadTextFile", count, text.size(), [&](size_t i)
+	{
+		return FileUtils::ReadTextFile(ioPath / ("file_" + std::to_string(i) + ".txt")).size() == text.size();
+	});
+
+	FileUtils::DeleteFolder(ioPath);
+}
+
+void Benchmark::BenchmarkCopy()
+{
+	std::filesystem::path treePath = options.root / "CopyTree";
+	std::filesystem::path copyPath = options.root / "CopyFiles";
+	CreateTree(treePath);
+	FileUtils::CreateNewFolder(copyPath);
+
+	Measure("CopyFile", options.fileCount, payload.size(), [&](size_t i)
+	{
+		return FileUtils::CopyFile(GetTreeFile(treePath, i), copyPath / ("file_" + std::to_string(i) + ".bin"));
+	});
+
+	FileUtils::DeleteFolder(copyPath);
+
+	Measure("CopyFolder", options.iterations, payload.size() * options.fileCount, [&](size_t i)
+	{
+		std::filesystem::path destination = options.root / ("CopyFolder" + std::to_string(i));
+		bool success = FileUtils::CopyFolder(treePath, destination);
+		FileUtils::DeleteFolder(destination); // Not excluded from the timing, copies of a large tree would fill the disk otherwise
+		return success;
+	});
+
+	FileUtils::DeleteFolder(treePath);
+}
+
+void Benchmark::BenchmarkMoveAndDelete()
+{
+	std::filesystem::path treePath = options.root / "MoveTree";
+	std::filesystem::path movePath = options.root / "Moved";
+	CreateTree(treePath);
+	FileUtils::CreateNewFolder(movePath);
+	size_t count = options.fileCount;
+
+	Measure("RenameFile", count, 0, [&](size_t i)
+	{
+		std::filesystem::path file = GetTreeFile(treePath, i);
+		return FileUtils::RenameFile(file, file.parent_path() / ("renamed_" + std::to_string(i) + ".bin"));
+	});
+
+	Measure("MoveFile", count, 0, [&](size_t i)
+	{
+		std::filesystem::path file = GetTreeFile(treePath, i);
+		return FileUtils::MoveFile(file.parent_path() / ("renamed_" + std::to_string(i) + ".bin"), movePath / file.filename());
+	});
+
+	Measure("DeleteFile", count, 0, [&](size_t i)
+	{
+		return FileUtils::DeleteFile(movePath / GetTreeFile(treePath, i).filename());
+	});
+
+	CreateTree(treePath);
+	std::vector<BatchOps::Operation> operations;
+	for (size_t i = 0; i < count; i++)
+	{
+		std::filesystem::path file = GetTreeFile(treePath, i);
+		operations.push_back({ BatchOps::OperationType::MoveFile, file, movePath / file.filename() });
+	}
+
+	BatchOps batch;
+	Measure("BatchOps::Run (MoveFile)", 1, 0, [&](size_t)
+	{
+		std::vector<bool> batchResults = batch.Run(operations);
+		return std::find(batchResults.begin(), batchResults.end(), false) == batchResults.end();
+	});
+	results.back().operations = count;
+
+	Measure("DeleteFolder", 1, 0, [&](size_t)
+	{
+		return FileUtils::DeleteFolder(movePath);
+	});
+
+	FileUtils::DeleteFolder(treePath);
+}
+
+void Benchmark::BenchmarkDiscovery()
+{
+	std::filesystem::path treePath = options.root / "DiscoveryTree";
+	CreateTree(treePath);
+
+	Measure("GetFilesByExtension", options.iterations, 0, [&](size_t i)
+	{
+		return !FileUtils::GetFilesByExtension(treePath / ("folder" + std::to_string(i % options.folderCount)), ".bin").empty();
+	});
+
+	Measure("GetFilesByName", options.iterations, 0, [&](size_t i)
+	{
+		return !FileUtils::GetFilesByName(treePath / ("folder" + std::to_string(i % options.folderCount)), "file_").empty();
+	});
+
+	Measure("GetFoldersByName", options.iterations, 0, [&](size_t)
+	{
+		return !FileUtils::GetFoldersByName(treePath, "folder").empty();
+	});
+
+	// One pass over the whole tree testing a few hundred patterns per name
+	std::vector<std::string> patterns;
+	for (int i = 0; i < 256; i++)
+		patterns.push_back("*_" + std::to_string(i) + "[0-9].bin");
+	PathMatcher matcher(patterns);
+
+	Measure("GetFilesByPattern (256 patterns)", options.iterations, 0, [&](size_t)
+	{
+		return !FileUtils::GetFilesByPattern(treePath, matcher, true).empty();
+	});
+
+	std::vector<std::filesystem::path> files;
+	for (int i = 0; i < options.fileCount; i++)
+		files.push_back(GetTreeFile(treePath, i));
+
+	Measure("GetMetadata", options.iterations, 0, [&](size_t)
+	{
+		return FileUtils::GetMetadata(files).types.size() == files.size();
+	});
+
+	Measure("GetFolderMetadata", options.iterations, 0, [&](size_t i)
+	{
+		return !FileUtils::GetFolderMetadata(treePath / ("folder" + std::to_string(i % options.folderCount))).paths.empty();
+	});
+
+	Measure("ScanTreeStats", options.iterations, 0, [&](size_t)
+	{
+		TreeStats stats = FileUtils::ScanTreeStats(treePath);
+		return !stats.folders.empty() && stats.folders[0].fileCount == (uint64_t)options.fileCount;
+	});
+
+	FileUtils::DeleteFolder(treePath);
+}
+
+void Benchmark::BenchmarkNameParsing()
+{
+	std::vector<std::filesystem::path> paths;
+	for (int i = 0; i < options.fileCount; i++)
+		paths.push_back(options.root / "Shot_010" / ("render_v" + std::to_string(i % 100) + "." + std::to_string(i) + ".exr"));
+
+	size_t count = paths.size();
+
+	Measure("GetFilename", count, 0, [&](size_t i) { return !FileUtils::GetFilename(paths[i]).empty(); });
+	Measure("GetFileExtension", count, 0, [&](size_t i) { return !FileUtils::GetFileExtension(paths[i]).empty(); });
+	Measure("GetFilenameWithExtension", count, 0, [&](size_t i) { return !FileUtils::GetFilenameWithExtension(paths[i]).empty(); });
+	Measure("GetParentFolder", count, 0, [&](size_t i) { return !FileUtils::GetParentFolder(paths[i]).empty(); });
+	Measure("GetIntFromFilename", count, 0, [&](size_t i) { return FileUtils::GetIntFromFilename(paths[i].filename().string()) >= 0; });
+}
+
+std::string Benchmark::ToJson()
+{
+	auto escape = [](std::string text)
+	{
+		std::string escaped;
+		for (char c : text)
+		{
+			if (c == '"' || c == '\\')
+				escaped += '\\';
+			escaped += c;
+		}
+		return escaped;
+	};
+
+	auto percentile = [](const std::vector<uint64_t>& sorted, double fraction)
+	{
+		if (sorted.empty())
+			return (uint64_t)0;
+		return sorted[std::min(sorted.size() - 1, (size_t)(fraction * sorted.size()))];
+	};
+
+	// Compile time features of this build, so reports of different builds can be told apart
+	std::vector<std::string> features;
+#ifdef FILEUTILS_HAVE_COPY_FILE_RANGE
+	features.push_back("copy_file_range");
+#endif
+#ifdef FILEUTILS_HAVE_STATX
+	features.push_back("statx");
+#endif
+#ifdef FILEUTILS_HAVE_FALLOCATE
+	features.push_back("fallocate");
+#endif
+#ifdef FILEUTILS_HAVE_SEEK_DATA
+	features.push_back("seek_data");
+#endif
+#ifdef FILEUTILS_ENABLE_METRICS
+	features.push_back("metrics");
+#endif
+
+	std::ostringstream json;
+	json << "{\n";
+	json << "  \"label\": \"" << escape(options.label) << "\",\n";
+	json << "  \"features\": [";
+	for (size_t i = 0; i < features.size(); i++)
+		json << (i ? ", " : "") << "\"" << features[i] << "\"";
+	json << "],\n";
+	json << "  \"config\": { \"file_count\": " << options.fileCount << ", \"folder_count\": " << options.folderCount
+		<< ", \"file_size\": " << options.fileSize << ", \"iterations\": " << options.iterations << " },\n";
+	json << "  \"results\": [\n";
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const Result& result = results[i];
+		double seconds = result.seconds > 0 ? result.seconds : 1e-9;
+
+		json << "    { \"name\": \"" << escape(result.name) << "\""
+			<< ", \"operations\": " << result.operations
+			<< ", \"failures\": " << result.failures
+			<< ", \"seconds\": " << result.seconds
+			<< ", \"ops_per_sec\": " << result.operations / seconds
+			<< ", \"mb_per_sec\": " << result.bytes / seconds / (1024.0 * 1024.0)
+			<< ", \"latency_ns\": { \"p50\": " << percentile(result.latenciesNs, 0.50)
+			<< ", \"p90\": " << percentile(result.latenciesNs, 0.90)
+			<< ", \"p99\": " << percentile(result.latenciesNs, 0.99)
+			<< ", \"max\": " << (result.latenciesNs.empty() ? 0 : result.latenciesNs.back()) << " }"
+			<< ", \"allocations\": " << result.allocations
+			<< ", \"allocated_bytes\": " << result.allocatedBytes
+			<< " }" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+
+	json << "  ]\n}\n";
+	return json.str();
+}
+
+int Benchmark::RunAll(Options benchmarkOptions)
+{
+	options = benchmarkOptions;
+	if (options.fileCount < 1 || options.folderCount < 1 || options.iterations < 1)
+	{
+		Log("File count, folder count and iterations have to be at least 1");
+		return 1;
+	}
+
+	if (FileUtils::FolderExists(options.root))
+	{
+		Log("Benchmark folder " + options.root.string() + " already exists, refusing to overwrite it");
+		return 1;
+	}
+
+	if (!FileUtils::CreateNewFolder(options.root))
+	{
+		Log("Could not create benchmark folder " + options.root.string());
+		return 1;
+	}
+
+	payload.resize(options.fileSize);
+	for (size_t i = 0; i < payload.size(); i++)
+		payload[i] = (char)(i * 31 + 7);
+
+	BenchmarkFileIO();
+	BenchmarkCopy();
+	BenchmarkMoveAndDelete();
+	BenchmarkDiscovery();
+	BenchmarkNameParsing();
+
+	FileUtils::DeleteFolder(options.root);
+
+	std::string json = ToJson();
+	if (options.jsonOutput.empty())
+		std::cout << json;
+
+	else if (!FileUtils::WriteTextFile(options.jsonOutput, json))
+	{
+		Log("Could not write " + options.jsonOutput.string());
+		return 1;
+	}
+
+	return 0;
+}
+
+
+int main(int argc, char* argv[])
+{
+	Benchmark::Options options;
+	options.root = std::filesystem::temp_directory_path() / "FileUtilBenchmark";
+
+	std::string usage = "Usage: benchmark [--dir path] [--json file] [--label text] [--files n] [--folders n] [--size bytes] [--iterations n]";
+
+	for (int i = 1; i < argc; i += 2)
+	{
+		std::string argument = argv[i];
+		if (i + 1 >= argc)
+		{
+			std::cerr << "Missing value for " << argument << std::endl << usage << std::endl;
+			return 1;
+		}
+
+		std::string value = argv[i + 1];
+
+		try
+		{
+			if (argument == "--dir")
+				options.root = value;
+			else if (argument == "--json")
+				options.jsonOutput = value;
+			else if (argument == "--label")
+				options.label = value;
+			else if (argument == "--files")
+				options.fileCount = std::stoi(value);
+			else if (argument == "--folders")
+				options.folderCount = std::stoi(value);
+			else if (argument == "--size")
+				options.fileSize = std::stoull(value);
+			else if (argument == "--iterations")
+				options.iterations = std::stoi(value);
+			else
+			{
+				std::cerr << "Unknown argument " << argument << std::endl << usage << std::endl;
+				return 1;
+			}
+		}
+
+		catch (...)
+		{
+			std::cerr << "Invalid value for " << argument << ": " << value << std::endl << usage << std::endl;
+			return 1;
+		}
+	}
+
+	Benchmark benchmark;
+	return benchmark.RunAll(options);
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "FileUtils.h"
+#include "BatchOps.h"
+#include "PathMatcher.h"
+#include "TreeStats.h"
+#include <cstdint>
+
+
+class Benchmark
+{
+public:
+	struct Options
+	{
+		std::filesystem::path root;			// Folder in which the synthetic tree is generated, removed again afterwards
+		std::filesystem::path jsonOutput;	// Where to write the JSON report, empty writes it to stdout
+		std::string label;					// Free text stored in the report, e.g. the version or commit under test
+		int fileCount = 1000;
+		int folderCount = 10;
+		size_t fileSize = 64 * 1024;
+		int iterations = 20;				// Repetitions of the folder-wide operations (discovery, folder copy)
+	};
+
+	int RunAll(Options options);
+
+private:
+	struct Result
+	{
+		std::string name;
+		size_t operations = 0;
+		size_t failures = 0;
+		uint64_t bytes = 0;
+		double seconds = 0;
+		std::vector<uint64_t> latenciesNs;
+		uint64_t allocations = 0;
+		uint64_t allocatedBytes = 0;
+	};
+
+	template <typename Operation>
+	void Measure(std::string name, size_t count, uint64_t bytesPerOperation, Operation operation);
+
+	void Log(std::string message);
+	void CreateTree(std::filesystem::path treePath);
+	std::filesystem::path GetTreeFile(std::filesystem::path treePath, size_t index);
+
+	void BenchmarkFileIO();
+	void BenchmarkCopy();
+	void BenchmarkMoveAndDelete();
+	void BenchmarkDiscovery();
+	void BenchmarkNameParsing();
+
+	std::string ToJson();
+
+	Options options;
+	std::vector<char> payload;
+	std::vector<Result> results;
+};
@@ -0,0 +1,801 @@
+#include "FileUtils.h"
+#include "FileUtilsInternal.h"
+#include "AlignedBufferPool.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#ifdef FILEUTILS_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+
+// The binary IO and copy functions that take FileIOOptions. They work on file descriptors, so preallocation, sparse
+// files and direct IO can be handled with the system calls for them. Other platforms go through the streams and ignore the options.
+
+#ifdef FILEUTILS_POSIX
+// Size of the buffer for copying data regions, when copy_file_range is not available or refuses the files
+static const size_t CopyBufferSize = 1024 * 1024;
+
+// Largest transfer per system call, Linux never moves more than about 2 GB at once anyway
+static const uint64_t MaxTransferSize = 1 << 30;
+
+namespace
+{
+    // Closes the descriptor when leaving the scope, unless it was released to be closed with error checking
+    struct FileDescriptor
+    {
+        int fd;
+
+        explicit FileDescriptor(int fd) : fd(fd) {}
+        ~FileDescriptor() { if (fd >= 0) close(fd); }
+        FileDescriptor(const FileDescriptor&) = delete;
+        FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+        int Release()
+        {
+            int released = fd;
+            fd = -1;
+            return released;
+        }
+    };
+
+    // The byte range [offset, offset + length) of a file
+    struct Region
+    {
+        uint64_t offset;
+        uint64_t length;
+    };
+
+    // A descriptor used for aligned transfers, direct is cleared when the file has to fall back to buffered IO
+    struct TransferFile
+    {
+        int fd;
+        bool direct;
+    };
+}
+
+static bool WriteAll(int fd, const char* data, uint64_t length, uint64_t offset, uint64_t& syscalls)
+{
+    while (length > 0)
+    {
+        syscalls++;
+        ssize_t written = pwrite(fd, data, (size_t)std::min(length, MaxTransferSize), (off_t)offset);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        data += written;
+        length -= written;
+        offset += written;
+    }
+
+    return true;
+}
+
+static bool ReadAll(int fd, char* data, uint64_t length, uint64_t offset, uint64_t& syscalls)
+{
+    while (length > 0)
+    {
+        syscalls++;
+        ssize_t read = pread(fd, data, (size_t)std::min(length, MaxTransferSize), (off_t)offset);
+        if (read < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        // The file got shorter since its size was queried
+        if (read == 0)
+            return false;
+
+        data += read;
+        length -= read;
+        offset += read;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Reads up to length bytes, less only when reaching fileSize. Never reads at an offset past fileSize, direct IO would refuse the unaligned offset.
+/// </summary>
+static bool ReadChunk(int fd, char* data, uint64_t length, uint64_t offset, uint64_t fileSize, uint64_t& read, uint64_t& syscalls)
+{
+    read = 0;
+    while (read < length && offset + read < fileSize)
+    {
+        syscalls++;
+        ssize_t count = pread(fd, data + read, (size_t)std::min(length - read, MaxTransferSize), (off_t)(offset + read));
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        if (count == 0)
+            break;
+
+        read += count;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Switches an open descriptor to or from direct IO. Done after opening instead of passing O_DIRECT to open,
+/// because a file system that refuses O_DIRECT fails the open only after O_CREAT/O_TRUNC took effect.
+/// </summary>
+/// <returns>False if the platform or the file system does not support direct IO, the descriptor then stays as it was</returns>
+static bool SetDirectIO(int fd, bool enable, uint64_t& syscalls)
+{
+#if defined(O_DIRECT)
+    syscalls += 2;
+    int flags = fcntl(fd, F_GETFL);
+    return flags >= 0 && fcntl(fd, F_SETFL, enable ? flags | O_DIRECT : flags & ~O_DIRECT) == 0;
+#elif defined(F_NOCACHE)
+    syscalls++;
+    return fcntl(fd, F_NOCACHE, enable ? 1 : 0) == 0;
+#else
+    (void)fd;
+    (void)enable;
+    (void)syscalls;
+    return false;
+#endif
+}
+
+/// <summary>
+/// Reads a chunk for an aligned transfer. Devices that need a larger alignment than AlignedBufferPool::Alignment
+/// reject direct reads with EINVAL, then the file continues with buffered IO.
+/// </summary>
+static bool ReadAligned(TransferFile& file, char* data, uint64_t length, uint64_t offset, uint64_t fileSize, uint64_t& read, uint64_t& syscalls)
+{
+    if (ReadChunk(file.fd, data, length, offset, fileSize, read, syscalls))
+        return true;
+
+    if (!file.direct || errno != EINVAL || !SetDirectIO(file.fd, false, syscalls))
+        return false;
+
+    file.direct = false;
+    return ReadChunk(file.fd, data, length, offset, fileSize, read, syscalls);
+}
+
+/// <summary>
+/// Writes a chunk for an aligned transfer, with the same fallback as ReadAligned
+/// </summary>
+static bool WriteAligned(TransferFile& file, const char* data, uint64_t length, uint64_t offset, uint64_t& syscalls)
+{
+    if (WriteAll(file.fd, data, length, offset, syscalls))
+        return true;
+
+    if (!file.direct || errno != EINVAL || !SetDirectIO(file.fd, false, syscalls))
+        return false;
+
+    file.direct = false;
+    return WriteAll(file.fd, data, length, offset, syscalls);
+}
+
+/// <summary>
+/// Rounds the regions out to AlignedBufferPool::Alignment and merges the ones that overlap afterwards. The end of the
+/// last region may move past the end of the file: reads stop at the end, writes get truncated to the file size afterwards.
+/// </summary>
+static std::vector<Region> AlignRegions(const std::vector<Region>& regions)
+{
+    const uint64_t alignment = AlignedBufferPool::Alignment;
+    std::vector<Region> aligned;
+
+    for (const Region& region : regions)
+    {
+        uint64_t start = region.offset / alignment * alignment;
+        uint64_t end = (region.offset + region.length + alignment - 1) / alignment * alignment;
+
+        if (!aligned.empty() && aligned.back().offset + aligned.back().length >= start)
+            aligned.back().length = std::max(aligned.back().offset + aligned.back().length, end) - aligned.back().offset;
+        else
+            aligned.push_back({ start, end - start });
+    }
+
+    return aligned;
+}
+
+/// <summary>
+/// Drops the cached pages of a file that was read with buffered IO although direct IO was asked for, so it does not stay in the cache either
+/// </summary>
+static void DropCache(int fd, uint64_t& syscalls)
+{
+#ifdef POSIX_FADV_DONTNEED
+    syscalls++;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#else
+    (void)fd;
+    (void)syscalls;
+#endif
+}
+
+/// <summary>
+/// Flushes a file that was written with buffered IO although direct IO was asked for, then drops its cached pages.
+/// Dirty pages cannot be dropped, so without the flush the written data would stay in the cache.
+/// </summary>
+/// <returns>False if the flush failed, the data may not have reached the disk then</returns>
+static bool FlushAndDropCache(int fd, uint64_t& syscalls)
+{
+#ifdef POSIX_FADV_DONTNEED
+    syscalls++;
+    if (fdatasync(fd) != 0)
+        return false;
+
+    DropCache(fd, syscalls);
+#else
+    (void)fd;
+    (void)syscalls;
+#endif
+    return true;
+}
+
+static bool IsZero(const char* data, size_t length)
+{
+    // Compares the block with itself shifted by one byte, so every byte equals the first one. No zero buffer needed.
+    return length == 0 || (data[0] == 0 && memcmp(data, data + 1, length - 1) == 0);
+}
+
+/// <summary>
+/// Get the regions of a buffer that have to be written to a sparse file, the blocks that are not all zeros
+/// </summary>
+static std::vector<Region> GetNonZeroRegions(const char* bytes, uint64_t size, size_t blockSize)
+{
+    std::vector<Region> regions;
+    if (blockSize == 0)
+        blockSize = 4096;
+
+    for (uint64_t offset = 0; offset < size; offset += blockSize)
+    {
+        uint64_t length = std::min<uint64_t>(blockSize, size - offset);
+        if (IsZero(bytes + offset, (size_t)length))
+            continue;
+
+        if (!regions.empty() && regions.back().offset + regions.back().length == offset)
+            regions.back().length += length;
+        else
+            regions.push_back({ offset, length });
+    }
+
+    return regions;
+}
+
+/// <summary>
+/// Get the regions of an open file that hold data. Everything in between is a hole and reads as zeros.
+/// </summary>
+/// <param name="sparse">Look for holes at all. Without this, or if the file system can not tell, the whole file is one region</param>
+static std::vector<Region> GetDataRegions(int fd, uint64_t size, bool sparse, uint64_t& syscalls)
+{
+    std::vector<Region> regions;
+
+#ifdef FILEUTILS_HAVE_SEEK_DATA
+    if (sparse)
+    {
+        bool supported = true;
+        for (uint64_t offset = 0; offset < size;)
+        {
+            syscalls++;
+            off_t data = lseek(fd, (off_t)offset, SEEK_DATA);
+            if (data < 0)
+            {
+                // ENXIO: nothing but a hole up to the end of the file
+                supported = errno == ENXIO;
+                break;
+            }
+
+            if ((uint64_t)data >= size)
+                break;
+
+            syscalls++;
+            off_t hole = lseek(fd, data, SEEK_HOLE);
+            uint64_t end = hole < 0 ? 0 : std::min((uint64_t)hole, size);
+            if (end <= (uint64_t)data)
+            {
+                supported = false;
+                break;
+            }
+
+            regions.push_back({ (uint64_t)data, end - (uint64_t)data });
+            offset = end;
+        }
+
+        if (supported)
+            return regions;
+
+        regions.clear();
+    }
+#endif
+
+    if (size > 0)
+        regions.push_back({ 0, size });
+
+    return regions;
+}
+
+/// <summary>
+/// Reserves the disk space of a region. Only a hint: without fallocate, or on file systems that don't support it, nothing happens
+/// </summary>
+static void Preallocate(int fd, const Region& region, uint64_t& syscalls)
+{
+#ifdef FILEUTILS_HAVE_FALLOCATE
+    syscalls++;
+    if (fallocate(fd, 0, (off_t)region.offset, (off_t)region.length) != 0)
+        return;
+#else
+    (void)fd;
+    (void)region;
+    (void)syscalls;
+#endif
+}
+
+static bool CopyRegion(int source, int destination, Region region, std::unique_ptr<char[]>& buffer, uint64_t& syscalls)
+{
+#ifdef FILEUTILS_HAVE_COPY_FILE_RANGE
+    // Copies inside the kernel, or shares the blocks on file systems with reflinks. Some kernels refuse
+    // (e.g. across file systems), then the rest of the region goes through the buffer.
+    loff_t sourceOffset = (loff_t)region.offset;
+    loff_t destinationOffset = (loff_t)region.offset;
+    while (region.length > 0)
+    {
+        syscalls++;
+        ssize_t copied = copy_file_range(source, &sourceOffset, destination, &destinationOffset, (size_t)std::min(region.length, MaxTransferSize), 0);
+        if (copied < 0 && errno == EINTR)
+            continue;
+        if (copied <= 0)
+            break;
+
+        region.offset += copied;
+        region.length -= copied;
+    }
+#endif
+
+    if (region.length > 0 && !buffer)
+        buffer.reset(new char[CopyBufferSize]);
+
+    while (region.length > 0)
+    {
+        uint64_t chunk = std::min<uint64_t>(region.length, CopyBufferSize);
+        if (!ReadAll(source, buffer.get(), chunk, region.offset, syscalls) || !WriteAll(destination, buffer.get(), chunk, region.offset, syscalls))
+            return false;
+
+        region.offset += chunk;
+        region.length -= chunk;
+    }
+
+    return true;
+}
+#endif
+
+
+/// <summary>
+/// Write the contents of a bytes buffer to a file, optionally preallocated and/or sparse. If the file already exists, it'll be overridden.
+/// </summary>
+/// <param name="path">The path to the file</param>
+/// <param name="bytes">The byte buffer</param>
+/// <param name="size">The size of the byte buffer</param>
+/// <param name="options">preallocate reserves the disk space up front, sparse leaves holes instead of writing blocks of zeros, directIO bypasses the page cache</param>
+/// <returns>True when file could be written, false when an error has occured</returns>
+bool FileUtils::WriteBinaryFile(std::filesystem::path path, const char* bytes, size_t size, const FileIOOptions& options)
+{
+    FILEUTILS_METRICS_SCOPE(WriteBinaryFile);
+
+    if (!FolderExists(path.parent_path()))
+        return FILEUTILS_METRICS_RESULT(false);
+
+#ifdef FILEUTILS_POSIX
+    uint64_t syscalls = 2; // Open and truncate
+    FileDescriptor file(open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666));
+    if (file.fd < 0)
+    {
+        FILEUTILS_METRICS_SYSCALLS(1);
+        return FILEUTILS_METRICS_RESULT(false);
+    }
+
+    std::vector<Region> regions;
+    if (options.sparse)
+        regions = GetNonZeroRegions(bytes, size, options.sparseBlockSize);
+    else if (size > 0)
+        regions.push_back({ 0, size });
+
+    // The final size is set first, whatever is not written afterwards stays a hole
+    bool success = ftruncate(file.fd, (off_t)size) == 0;
+
+    if (options.preallocate)
+    {
+        for (const Region& region : regions)
+            Preallocate(file.fd, region, syscalls);
+    }
+
+    uint64_t written = 0;
+    if (options.directIO)
+    {
+        TransferFile transfer = { file.fd, SetDirectIO(file.fd, true, syscalls) };
+        AlignedBufferPool::Buffer buffer = AlignedBufferPool::GetShared().Acquire();
+
+        for (const Region& region : AlignRegions(regions))
+        {
+            uint64_t end = region.offset + region.length;
+            for (uint64_t offset = region.offset; success && offset < end; offset += buffer.GetSize())
+            {
+                uint64_t chunk = std::min<uint64_t>(buffer.GetSize(), end - offset);
+                const char* source = bytes + offset;
+
+                // Whole chunks of aligned caller memory can be written as they are, everything else goes through the aligned buffer.
+                // The bytes past the end of the data are padding for the last block, truncated again below.
+                if (offset + chunk > size || (uintptr_t)source % AlignedBufferPool::Alignment != 0)
+                {
+                    uint64_t available = std::min(chunk, size - offset);
+                    memcpy(buffer.GetData(), source, (size_t)available);
+                    memset(buffer.GetData() + available, 0, (size_t)(chunk - available));
+                    source = buffer.GetData();
+                }
+
+                success = WriteAligned(transfer, source, chunk, offset, syscalls);
+                written += chunk;
+            }
+        }
+
+        syscalls++;
+        success = success && ftruncate(file.fd, (off_t)size) == 0;
+
+        if (!transfer.direct)
+            success = success && FlushAndDropCache(file.fd, syscalls);
+    }
+
+    else
+    {
+        for (const Region& region : regions)
+        {
+            if (!success)
+                break;
+
+            success = WriteAll(file.fd, bytes + region.offset, region.length, region.offset, syscalls);
+            written += region.length;
+        }
+    }
+
+    // Errors of delayed writes (e.g. a full disk on NFS) only show up on close
+    syscalls++;
+    success = close(file.Release()) == 0 && success;
+
+    FILEUTILS_METRICS_SYSCALLS(syscalls);
+    FILEUTILS_METRICS_BYTES(written);
+    return FILEUTILS_METRICS_RESULT(success);
+#else
+    (void)options;
+    FILEUTILS_METRICS_SYSCALLS(3); // Open, write and close
+    std::ofstream file(path.c_str(), std::ios::binary);
+    if (!file.is_open())
+        return FILEUTILS_METRICS_RESULT(false);
+
+    file.write(bytes, (std::streamsize)size);
+    file.close();
+    FILEUTILS_METRICS_BYTES(size);
+    return FILEUTILS_METRICS_RESULT(!file.fail());
+#endif
+}
+
+/// <summary>
+/// Reads all the contents of a binary file into a byte buffer. With options.sparse only the data regions of the file are read, holes are filled with zeros.
+/// </summary>
+/// <param name="path">The path to the file</param>
+/// <param name="options">The IO options, sparse and directIO are used</param>
+/// <param name="size">Receives the size of the buffer if not null, 0 on errors</param>
+/// <returns>The pointer to the read byte buffer, if an error has occured a nullpointer will be returned.
+/// Don't forget to delete the buffer when you're done using it. </returns>
+char* FileUtils::ReadBinaryFile(std::filesystem::path path, const FileIOOptions& options, size_t* size)
+{
+    FILEUTILS_METRICS_SCOPE(ReadBinaryFile);
+
+    if (size)
+        *size = 0;
+
+    if (!FileExists(path))
+    {
+        FILEUTILS_METRICS_FAIL();
+        return nullptr;
+    }
+
+#ifdef FILEUTILS_POSIX
+    uint64_t syscalls = 3; // Open, stat and close
+    FileDescriptor file(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    struct stat info;
+    if (file.fd < 0 || fstat(file.fd, &info) != 0)
+    {
+        FILEUTILS_METRICS_SYSCALLS(2);
+        FILEUTILS_METRICS_FAIL();
+        return nullptr;
+    }
+
+    uint64_t fileSize = (uint64_t)info.st_size;
+    std::unique_ptr<char[]> buffer(new char[fileSize]);
+    std::vector<Region> regions = GetDataRegions(file.fd, fileSize, options.sparse, syscalls);
+    uint64_t position = 0;
+    uint64_t read = 0;
+    bool success = true;
+
+    if (options.directIO)
+    {
+        TransferFile transfer = { file.fd, SetDirectIO(file.fd, true, syscalls) };
+        AlignedBufferPool::Buffer alignedBuffer = AlignedBufferPool::GetShared().Acquire();
+
+        for (const Region& region : AlignRegions(regions))
+        {
+            memset(buffer.get() + position, 0, (size_t)(region.offset - position));
+            uint64_t end = std::min(region.offset + region.length, fileSize);
+
+            for (uint64_t offset = region.offset; success && offset < end; offset += alignedBuffer.GetSize())
+            {
+                // The last chunk asks for whole blocks and gets the unaligned tail of the file back. A file that grew
+                // since the fstat returns more than that, only the bytes up to the size the buffer was made for are kept.
+                uint64_t chunk = std::min<uint64_t>(alignedBuffer.GetSize(), region.offset + region.length - offset);
+                uint64_t expected = std::min(chunk, fileSize - offset);
+                uint64_t chunkRead = 0;
+                success = ReadAligned(transfer, alignedBuffer.GetData(), chunk, offset, fileSize, chunkRead, syscalls) && chunkRead >= expected;
+                if (!success)
+                    break;
+
+                memcpy(buffer.get() + offset, alignedBuffer.GetData(), (size_t)expected);
+                read += expected;
+            }
+
+            if (!success)
+                break;
+
+            position = end;
+        }
+
+        if (!transfer.direct)
+            DropCache(file.fd, syscalls);
+    }
+
+    else
+    {
+        for (const Region& region : regions)
+        {
+            // Holes read as zeros, there is nothing on the disk to read for them
+            memset(buffer.get() + position, 0, (size_t)(region.offset - position));
+            success = ReadAll(file.fd, buffer.get() + region.offset, region.length, region.offset, syscalls);
+            if (!success)
+                break;
+
+            position = region.offset + region.length;
+            read += region.length;
+        }
+    }
+
+    FILEUTILS_METRICS_SYSCALLS(syscalls);
+    if (!success)
+    {
+        FILEUTILS_METRICS_FAIL();
+        return nullptr;
+    }
+
+    memset(buffer.get() + position, 0, (size_t)(fileSize - position));
+    FILEUTILS_METRICS_BYTES(read);
+
+    if (size)
+        *size = (size_t)fileSize;
+
+    return buffer.release();
+#else
+    (void)options;
+    FILEUTILS_METRICS_SYSCALLS(5); // Open, two seeks, read and close
+    std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        FILEUTILS_METRICS_FAIL();
+        return nullptr;
+    }
+
+    std::streamsize fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+    char* buffer = new char[fileSize];
+    file.read(buffer, fileSize);
+    file.close();
+
+    if (file.fail())
+    {
+        FILEUTILS_METRICS_FAIL();
+        delete[] buffer;
+        return nullptr;
+    }
+
+    FILEUTILS_METRICS_BYTES(fileSize);
+    if (size)
+        *size = (size_t)fileSize;
+
+    return buffer;
+#endif
+}
+
+/// <summary>
+/// Copies the file to a new location. With options.sparse only the data regions are copied and the holes of the source stay holes in the copy.
+/// </summary>
+/// <param name="src">The current path of the file</param>
+/// <param name="dest">The desired location of the duplicated file, including its own file name and extension</param>
+/// <param name="options">preallocate reserves the disk space of the copy up front, sparse keeps the holes, directIO bypasses the page cache for both files</param>
+/// <returns>Returns true when files could be copied, false if an error has occured, or destination already exists</returns>
+bool FileUtils::CopyFile(std::filesystem::path src, std::filesystem::path dest, const FileIOOptions& options)
+{
+    FILEUTILS_METRICS_SCOPE(CopyFile);
+
+    if (!FileExists(src) || FileExists(dest))
+        return FILEUTILS_METRICS_RESULT(false);
+
+#ifdef FILEUTILS_POSIX
+    uint64_t syscalls = 2; // Open and stat
+    FileDescriptor source(open(src.c_str(), O_RDONLY | O_CLOEXEC));
+    struct stat info;
+    if (source.fd < 0 || fstat(source.fd, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        FILEUTILS_METRICS_SYSCALLS(syscalls);
+        return FILEUTILS_METRICS_RESULT(false);
+    }
+
+    // O_EXCL: the destination must not exist, same as for the check above but without the race
+    syscalls++;
+    FileDescriptor destination(open(dest.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, info.st_mode & 0777));
+    if (destination.fd < 0)
+    {
+        FILEUTILS_METRICS_SYSCALLS(syscalls);
+        return FILEUTILS_METRICS_RESULT(false);
+    }
+
+    uint64_t size = (uint64_t)info.st_size;
+    std::vector<Region> regions = GetDataRegions(source.fd, size, options.sparse, syscalls);
+
+    syscalls++;
+    bool success = ftruncate(destination.fd, (off_t)size) == 0;
+
+    if (options.preallocate)
+    {
+        for (const Region& region : regions)
+            Preallocate(destination.fd, region, syscalls);
+    }
+
+    uint64_t copied = 0;
+    if (options.directIO)
+    {
+        // No copy_file_range here, it goes through the page cache on most file systems
+        TransferFile reader = { source.fd, SetDirectIO(source.fd, true, syscalls) };
+        TransferFile writer = { destination.fd, SetDirectIO(destination.fd, true, syscalls) };
+        AlignedBufferPool::Buffer buffer = AlignedBufferPool::GetShared().Acquire();
+
+        for (const Region& region : AlignRegions(regions))
+        {
+            uint64_t end = std::min(region.offset + region.length, size);
+            for (uint64_t offset = region.offset; success && offset < end; offset += buffer.GetSize())
+            {
+                uint64_t chunk = std::min<uint64_t>(buffer.GetSize(), region.offset + region.length - offset);
+                uint64_t expected = std::min(chunk, size - offset);
+                uint64_t read = 0;
+                success = ReadAligned(reader, buffer.GetData(), chunk, offset, size, read, syscalls) && read >= expected;
+                read = std::min(read, expected);    // Whatever the source grew by since the fstat is not copied
+
+                // The unaligned tail is written as a whole padded block, the truncate below cuts the padding off again
+                uint64_t padded = (read + AlignedBufferPool::Alignment - 1) / AlignedBufferPool::Alignment * AlignedBufferPool::Alignment;
+                memset(buffer.GetData() + read, 0, (size_t)(padded - read));
+                success = success && WriteAligned(writer, buffer.GetData(), padded, offset, syscalls);
+                copied += read;
+            }
+        }
+
+        syscalls++;
+        success = success && ftruncate(destination.fd, (off_t)size) == 0;
+
+        if (!reader.direct)
+            DropCache(source.fd, syscalls);
+        if (!writer.direct)
+            success = success && FlushAndDropCache(destination.fd, syscalls);
+    }
+
+    else
+    {
+        std::unique_ptr<char[]> buffer;
+        for (const Region& region : regions)
+        {
+            if (!success)
+                break;
+
+            success = CopyRegion(source.fd, destination.fd, region, buffer, syscalls);
+            copied += region.length;
+        }
+    }
+
+    // open applied the umask, the copy gets the exact permissions of the source
+    syscalls += 2;
+    success = fchmod(destination.fd, info.st_mode & 07777) == 0 && success;
+    success = close(destination.Release()) == 0 && success;
+
+    // Don't leave a partial copy behind
+    if (!success)
+    {
+        syscalls++;
+        unlink(dest.c_str());
+    }
+
+    FILEUTILS_METRICS_SYSCALLS(syscalls);
+    FILEUTILS_METRICS_BYTES(copied);
+    return FILEUTILS_METRICS_RESULT(success);
+#else
+    (void)options;
+
+    try
+    {
+        FILEUTILS_METRICS_SYSCALLS(1);
+        std::filesystem::copy_file(src, dest);
+    }
+
+    catch (...)
+    {
+        FILEUTILS_METRICS_EXCEPTION();
+        return false;
+    }
+
+    return true;
+#endif
+}
+
+/// <summary>
+/// Copies the folder and all of its contents to a new location, every file with CopyFile and the given options
+/// </summary>
+/// <param name="src">The current path of the folder</param>
+/// <param name="dest">The desired location of the duplicated folder, including its own folder name</param>
+/// <param name="options">The options for copying the files, see CopyFile</param>
+/// <returns>Returns true when folder could be copied, false if an error has occured, or destination folder already exists</returns>
+bool FileUtils::CopyFolder(std::filesystem::path src, std::filesystem::path dest, const FileIOOptions& options)
+{
+    FILEUTILS_METRICS_SCOPE(CopyFolder);
+
+    if (!FolderExists(src) || FolderExists(dest))
+        return FILEUTILS_METRICS_RESULT(false);
+
+    try
+    {
+        // Same walk as the plain CopyFolder: links are followed, folders keep their permissions and the parent of dest has to exist
+        FILEUTILS_METRICS_SYSCALLS(2); // Create the destination and open the source
+        std::filesystem::create_directory(dest, src);
+
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(src, std::filesystem::directory_options::follow_directory_symlink))
+        {
+            FILEUTILS_METRICS_ENTRIES(1);
+            std::filesystem::path target = dest / entry.path().lexically_relative(src);
+
+            if (entry.is_directory())
+            {
+                FILEUTILS_METRICS_SYSCALLS(1);
+                std::filesystem::create_directory(target, entry.path());
+            }
+
+            // Broken links, pipes, sockets and devices can't be copied, the plain overload fails on them as well
+            else if (!entry.is_regular_file() || !CopyFile(entry.path(), target, options))
+            {
+                return FILEUTILS_METRICS_RESULT(false);
+            }
+
+            else
+            {
+                FILEUTILS_METRICS_BYTES(entry.file_size());
+            }
+        }
+    }
+
+    catch (...)
+    {
+        FILEUTILS_METRICS_EXCEPTION();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,180 @@
+#include "FileUtils.h"
+#include "FileUtilsInternal.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+#ifdef FILEUTILS_POSIX
+#include <fcntl.h>
+#endif
+
+
+// Number of paths queried by one pool task. Batches up to this size are queried on the calling thread.
+static const size_t MetadataChunkSize = 512;
+
+#ifdef FILEUTILS_POSIX
+static FileMetadata::Type GetTypeFromMode(uint32_t mode)
+{
+    if (S_ISREG(mode))
+        return FileMetadata::Type::File;
+
+    if (S_ISDIR(mode))
+        return FileMetadata::Type::Folder;
+
+    return FileMetadata::Type::Other;
+}
+#endif
+
+/// <summary>
+/// Queries the metadata of metadata.paths[index] and stores the requested fields at the same index
+/// </summary>
+static void QueryMetadata(FileMetadata& metadata, size_t index, unsigned int fields)
+{
+    const std::filesystem::path& path = metadata.paths[index];
+
+#if defined(FILEUTILS_HAVE_STATX)
+    // statx only fetches what is asked for, which saves work on file systems where some fields are expensive (e.g. network mounts)
+    unsigned int mask = STATX_TYPE;
+    if (fields & FileMetadata::Size)
+        mask |= STATX_SIZE;
+    if (fields & FileMetadata::ModificationTime)
+        mask |= STATX_MTIME;
+    if (fields & FileMetadata::Mode)
+        mask |= STATX_MODE;
+    if (fields & FileMetadata::Inode)
+        mask |= STATX_INO;
+
+    struct statx info;
+    if (statx(AT_FDCWD, path.c_str(), AT_STATX_SYNC_AS_STAT, mask, &info) != 0 || !(info.stx_mask & STATX_TYPE))
+        return;
+
+    metadata.types[index] = GetTypeFromMode(info.stx_mode);
+    if (fields & FileMetadata::Size)
+        metadata.sizes[index] = (info.stx_mask & STATX_SIZE) ? info.stx_size : 0;
+    if (fields & FileMetadata::ModificationTime)
+        metadata.modificationTimes[index] = (info.stx_mask & STATX_MTIME) ? (int64_t)info.stx_mtime.tv_sec * 1000000000 + info.stx_mtime.tv_nsec : 0;
+    if (fields & FileMetadata::Mode)
+        metadata.modes[index] = info.stx_mode;
+    if (fields & FileMetadata::Inode)
+        metadata.inodes[index] = (info.stx_mask & STATX_INO) ? info.stx_ino : 0;
+
+#elif defined(FILEUTILS_POSIX)
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+        return;
+
+    metadata.types[index] = GetTypeFromMode(info.st_mode);
+    if (fields & FileMetadata::Size)
+        metadata.sizes[index] = (uint64_t)info.st_size;
+    if (fields & FileMetadata::ModificationTime)
+        metadata.modificationTimes[index] = GetModificationTimeNs(info);
+    if (fields & FileMetadata::Mode)
+        metadata.modes[index] = (uint32_t)info.st_mode;
+    if (fields & FileMetadata::Inode)
+        metadata.inodes[index] = (uint64_t)info.st_ino;
+
+#else
+    std::error_code error;
+    std::filesystem::file_status status = std::filesystem::status(path, error);
+    if (error || !std::filesystem::exists(status))
+        return;
+
+    if (std::filesystem::is_regular_file(status))
+        metadata.types[index] = FileMetadata::Type::File;
+    else if (std::filesystem::is_directory(status))
+        metadata.types[index] = FileMetadata::Type::Folder;
+    else
+        metadata.types[index] = FileMetadata::Type::Other;
+
+    if ((fields & FileMetadata::Size) && metadata.types[index] == FileMetadata::Type::File)
+    {
+        std::uintmax_t size = std::filesystem::file_size(path, error);
+        metadata.sizes[index] = error ? 0 : (uint64_t)size;
+    }
+
+    if (fields & FileMetadata::ModificationTime)
+    {
+        std::filesystem::file_time_type fileTime = std::filesystem::last_write_time(path, error);
+        if (!error)
+            metadata.modificationTimes[index] = FileTimeToUnixNs(fileTime);
+    }
+#endif
+}
+
+
+/// <summary>
+/// Get the metadata of many files or folders at once. The paths are queried in parallel on the shared thread pool.
+/// Links are followed, the metadata belongs to the link target.
+/// </summary>
+/// <param name="paths">The paths to query</param>
+/// <param name="fields">The fields to query, combined FileMetadata::Field flags. Asking only for what you need saves work on some file systems.</param>
+/// <returns>The metadata in the same order as the paths. Paths that could not be queried have the type NotFound and all fields set to 0</returns>
+FileMetadata FileUtils::GetMetadata(std::vector<std::filesystem::path> paths, unsigned int fields)
+{
+    FILEUTILS_METRICS_SCOPE(GetMetadata);
+    FILEUTILS_METRICS_SYSCALLS(paths.size());
+    FILEUTILS_METRICS_ENTRIES(paths.size());
+
+    FileMetadata metadata;
+    metadata.paths = std::move(paths);
+    size_t count = metadata.paths.size();
+    metadata.types.assign(count, FileMetadata::Type::NotFound);
+    if (fields & FileMetadata::Size)
+        metadata.sizes.assign(count, 0);
+    if (fields & FileMetadata::ModificationTime)
+        metadata.modificationTimes.assign(count, 0);
+    if (fields & FileMetadata::Mode)
+        metadata.modes.assign(count, 0);
+    if (fields & FileMetadata::Inode)
+        metadata.inodes.assign(count, 0);
+
+    if (count <= MetadataChunkSize)
+    {
+        for (size_t i = 0; i < count; i++)
+            QueryMetadata(metadata, i, fields);
+
+        return metadata;
+    }
+
+    // Every task writes its own index range, the arrays are sized up front and never reallocated
+    ThreadPool::TaskGroup group(ThreadPool::GetShared());
+    for (size_t start = 0; start < count; start += MetadataChunkSize)
+    {
+        size_t end = std::min(start + MetadataChunkSize, count);
+        group.Run([&metadata, start, end, fields]()
+        {
+            for (size_t i = start; i < end; i++)
+                QueryMetadata(metadata, i, fields);
+        });
+    }
+
+    group.Wait();
+    return metadata;
+}
+
+/// <summary>
+/// Get the metadata of all files and folders directly inside of a folder
+/// </summary>
+/// <param name="path">The folder whose content should be queried</param>
+/// <param name="fields">The fields to query, combined FileMetadata::Field flags</param>
+/// <returns>The metadata of the folder content, in no particular order. Empty if the folder does not exist or could not be read</returns>
+FileMetadata FileUtils::GetFolderMetadata(std::filesystem::path path, unsigned int fields)
+{
+    FILEUTILS_METRICS_SCOPE(GetFolderMetadata);
+    std::vector<std::filesystem::path> entries;
+
+    std::error_code error;
+    FILEUTILS_METRICS_SYSCALLS(1);
+    for (std::filesystem::directory_iterator entry(path, error), end; !error && entry != end; entry.increment(error))
+    {
+        FILEUTILS_METRICS_ENTRIES(1);
+        entries.push_back(entry->path());
+    }
+
+    if (error)
+    {
+        FILEUTILS_METRICS_FAIL();
+        return FileMetadata();
+    }
+
+    return GetMetadata(std::move(entries), fields);
+}
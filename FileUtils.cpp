@@ -0,0 +1,747 @@
+#include "FileUtils.h"
+#include "FileUtilsInternal.h"
+#include "PathMatcher.h"
+#include <fstream>
+#include <regex>
+#include <stdexcept>
+
+
+/// <summary>
+/// Does a folder exist?
+/// </summary>
+/// <param name="path">The path to the folder</param>
+/// <returns>Returns true if the folder exists, false if the folder could not be found</returns>
+bool FileUtils::FolderExists(std::filesystem::path path)
+{
+    FILEUTILS_METRICS_SCOPE(FolderExists);
+
+    try
+    {
+        FILEUTILS_METRICS_SYSCALLS(1);
+        if (!std::filesystem::exists(path))
+            return false;
+    }
+
+    catch (...)
+    {
+        FILEUTILS_METRICS_EXCEPTION();
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Creates a new folder at the given path. If the to be created folder sits inside one or multiple non-existing parent folders, they will also be created
+/// </summary>
+/// <param name="path">The desired directoy path where the folder should be created.</param>
+/// <returns>Returns true if the folder has been created or already exists, false when the folder could not be created</returns>
+bool FileUtils::CreateNewFolder(std::filesystem::path path)
+{
+    FILEUTILS_METRICS_SCOPE(CreateNewFolder);
+
+    if (FolderExists(path))
+        return true;
+
+    else
+    {
+        try
+        {
+            FILEUTILS_METRICS_SYSCALLS(1);
+            if (!std::filesystem::create_directories(path))
+                return FILEUTILS_METRICS_RESULT(false);
+        }
+
+        catch (...)
+        {
+            FILEUTILS_METRICS_EXCEPTION();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Removes the folder and recursively all the content inside of it
+/// </summary>
+/// <param name="path">The path to the folder</param>
+/// <returns>True when the folder has been deleted, false if it could not be deleted, or an error occured</returns>
+bool FileUtils::DeleteFolder(std::filesystem::path path)
+{
+    FILEUTILS_METRICS_SCOPE(DeleteFolder);
+
+    if (!FolderExists(path))
+        return true; //Debatable, but we assume that the non-existence of the dir was the intented action of the user, not the deletion itself
+
+    else
+    {
+        try
+        {
+            std::uintmax_t removed = std::filesystem::remove_all(path);
+            FILEUTILS_METRICS_SYSCALLS(removed + 1);
+            FILEUTILS_METRICS_ENTRIES(removed);
+            if (removed < 1)
+                return FILEUTILS_METRICS_RESULT(false); //When the path exists but nothing was deleted, indicates error
+        }
+
+        catch (...)
+        {
+            FILEUTILS_METRICS_EXCEPTION();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/// <summary>
+/// Rename a folder
+/// </summary>
+/// <param name="path">The path the folder with it's current name</param>
+/// <param name="newPath">The path to the folder with its new name</param>
+/// <returns>True when the folder was successfully renamed, false if an error occured during renaming</returns>
+bool FileUtils::RenameFolder(std::filesystem::path path, std::filesystem::path newPath)
+{
+    FILEUTILS_METRICS_SCOPE(RenameFolder);
+
+    if (!FolderExists(path) || FolderExists(newPath))
+        return FILEUTILS_METRICS_RESULT(false);
+
+    if (FolderExists(newPath))
+        return FILEUTILS_METRICS_RESULT(false);
+
+    try
+    {
+        FILEUTILS_METRICS_SYSCALLS(1);
+        std::filesystem::rename(path, newPath);
+    }
+
+    catch (...)
+    {
+        FILEUTILS_METRICS_EXCEPTION();
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Moves the directoy and it's contents to a new location. The parent path of the new folder has to already exist
+/// </summary>
+/// <param name="from">The path to the folder which will be moved</param>
+/// <param name="to">The path to the folder which will contain the moved folder</param>
+/// <returns>Returns true if the move has been succesfull, false if the folder could not be moved </returns>
+bool FileUtils::MoveFolder(std::filesystem::path from, std::filesystem::path to)
+{
+    FILEUTILS_METRICS_SCOPE(MoveFolder);
+    FILEUTILS_METRICS_SYSCALLS(1); // GetFolderName checks whether the path is a directory
+    to /= GetFolderName(from);
+
+    if (!FolderExists(from) || FolderExists(to))
+        return FILEUTILS_METRICS_RESULT(false);
+
+    try
+    {
+        FILEUTILS_METRICS_SYSCALLS(1);
+        std::filesystem::rename(from, to);
+    }
+
+    catch (...)
+    {
+        FILEUTILS_METRICS_EXCEPTION();
+        return false;
+    }
+
+    return true;
+}
+
+
+/// <summary>
+/// Copies the folder and all of its contents to a new location.
+/// </summary>
+/// <param name="src">The current path of the folder</param>
+/// <param name="dest">The desired location of the duplicated folder, including its own folder name</param>
+/// <returns>Returns true when folder could be copied, false if an error has occured, or destination folder already exists</returns>
+bool FileUtils::CopyFolder(std::filesystem::path source, std::filesystem::path destination)
+{
+    FILEUTILS_METRICS_SCOPE(CopyFolder);
+
+    if (!FolderExists(source) || FolderExists(destination))
+        return FILEUTILS_METRICS_RESULT(false);
+
+    try
+    {
+        // Same steps as std::filesystem::copy with copy_options::recursive, walked here to count what gets copied
+        FILEUTILS_METRICS_SYSCALLS(2); // Create the destination and open the source
+        std::filesystem::create_directory(destination, source);
+
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(source, std::filesystem::directory_options::follow_directory_symlink))
+        {
+            FILEUTILS_METRICS_ENTRIES(1);
+            FILEUTILS_METRICS_SYSCALLS(1);
+            std::filesystem::path target = destination / entry.path().lexically_relative(source);
+
+            if (entry.is_directory())
+            {
+                std::filesystem::create_directory(target, entry.path());
+            }
+            else
+            {
+                std::filesystem::copy(entry.path(), target, std::filesystem::copy_options::overwrite_existing);
+                FILEUTILS_METRICS_BYTES(entry.file_size());
+            }
+        }
+    }
+
+    catch (...)
+    {
+        FILEUTILS_METRICS_EXCEPTION();
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Does a file exist?
+/// </summary>
+/// <param name="path">The path to the file</param>
+/// <returns>Returns true if the file exists, false if the file could not be found</returns>
+bool FileUtils::FileExists(std::filesystem::path path)
+{
+    FILEUTILS_METRICS_SCOPE(FileExists);
+
+    try
+    {
+        FILEUTILS_METRICS_SYSCALLS(1);
+        if (!std::filesystem::exists(path))
+            return false;
+    }
+
+    catch (...)
+    {
+        FILEUTILS_METRICS_EXCEPTION();
+        return false;
+    }
+
+    return true;
+}
+
+
+/// <summary>
+/// Removes the file
+/// </summary>
+/// <param name="path">The path to the file</param>
+/// <returns>True when the file has been deleted, false if it could not be deleted, or an error occured</returns>
+bool FileUtils::DeleteFile(std::filesystem::path path)
+{
+    FILEUTILS_METRICS_SCOPE(DeleteFile);
+
+    if (!FileExists(path))
+        return true; //Debatable, but we assume that the non-existence of the file was the intented action of the user, not the deletion itself
+
+    else
+    {
+        try
+        {
+            FILEUTILS_METRICS_SYSCALLS(1);
+            if (!std::filesystem::remove(path))
+                return FILEUTILS_METRICS_RESULT(false);
+        }
+
+        catch (...)
+        {
+            FILEUTILS_METRICS_EXCEPTION();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/// <summary>
+/// Rename a file
+/// </summary>
+/// <param name="path">The path the file</param>
+/// <param name="newName">The new name of the file, including it's file extension</param>
+/// <returns>True when the file was successfully renamed, false if an error occured during renaming</returns>
+bool FileUtils::RenameFile(std::filesystem::path file, std::filesystem::path renamedFile)
+{
+    FILEUTILS_METRICS_SCOPE(RenameFile);
+
+    if (!FileExists(file) || FileExists(renamedFile))
+        return FILEUTILS_METRICS_RESULT(false);
+
+    try
+    {
+        FILEUTILS_METRICS_SYSCALLS(1);
+        std::filesystem::rename(file, renamedFile);
+    }
+
+    catch (...)
+    {
+        FILEUTILS_METRICS_EXCEPTION();
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Moves the file. The parent directory of the new file location has to already exist
+/// </summary>
+/// <param name="from">The current path to the file</param>
+/// <param name="to">The new path to the file, including it's own file name and extension</param>
+/// <returns>Returns true if the move has been succesfull, false if the file could not be moved </returns>
+bool FileUtils::MoveFile(std::filesystem::path from, std::filesystem::path to)
+{
+    FILEUTILS_METRICS_SCOPE(MoveFile);
+
+    if (!FileExists(from) || FileExists(to))
+        return FILEUTILS_METRICS_RESULT(false);
+
+    try
+    {
+        FILEUTILS_METRICS_SYSCALLS(1);
+        std::filesystem::rename(from, to);
+    }
+
+    catch (...)
+    {
+        FILEUTILS_METRICS_EXCEPTION();
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Copies the file to a new location.
+/// </summary>
+/// <param name="src">The current path of the file</param>
+/// <param name="dest">The desired location of the duplicated file, including its own file name and extension</param>
+/// <returns>Returns true when files could be copied, false if an error has occured, or destination already exists</returns>
+bool FileUtils::CopyFile(std::filesystem::path src, std::filesystem::path dest)
+{
+    FILEUTILS_METRICS_SCOPE(CopyFile);
+
+    if (!FileExists(src) || FileExists(dest))
+        return FILEUTILS_METRICS_RESULT(false);
+
+    try
+    {
+        FILEUTILS_METRICS_SYSCALLS(1);
+        std::filesystem::copy(src, dest, std::filesystem::copy_options::overwrite_existing);
+        FILEUTILS_METRICS_BYTES(std::filesystem::file_size(dest));
+    }
+
+    catch (...)
+    {
+        FILEUTILS_METRICS_EXCEPTION();
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Write a string to a file. If file already exists, it'll be overridden.
+/// </summary>
+/// <param name="path">The path to the folder where the file should be created</param>
+/// <param name="filename">The filename including it's extension</param>
+/// <param name="text">The content to write to the file</param>
+/// <returns>True if text was successfully written, false if an error occured</returns>
+bool FileUtils::WriteTextFile(std::filesystem::path path, std::string text)
+{
+    FILEUTILS_METRICS_SCOPE(WriteTextFile);
+
+    if (!FolderExists(path.parent_path()))
+        return FILEUTILS_METRICS_RESULT(false);
+
+    FILEUTILS_METRICS_SYSCALLS(1);
+    std::ofstream file(path.c_str());
+    if (file.is_open())
+    {
+        file << text.c_str();
+        file.close();
+        FILEUTILS_METRICS_SYSCALLS(2); // Write and close
+        FILEUTILS_METRICS_BYTES(text.size());
+        return FILEUTILS_METRICS_RESULT(!file.fail());
+    }
+
+    else
+        return FILEUTILS_METRICS_RESULT(false);
+}
+
+/// <summary>
+/// Reads the whole contents of a text file.
+/// </summary>
+/// <param name="path">The path to the text file</param>
+/// <returns>Returns the file contents, if file could not be read, an empty string will be returned</returns>
+std::string FileUtils::ReadTextFile(std::filesystem::path path)
+{
+    FILEUTILS_METRICS_SCOPE(ReadTextFile);
+
+    if (!FileExists(path))
+    {
+        FILEUTILS_METRICS_FAIL();
+        return std::string();
+    }
+
+    FILEUTILS_METRICS_SYSCALLS(1);
+    std::ifstream file(path.c_str(), std::ios::ate);
+    if (file.is_open())
+    {
+        std::streamsize size = file.tellg();
+        file.seekg(0, std::ios::beg);
+        std::string text(size, ' ');
+        file.read(&text[0], size);
+        file.close();
+        FILEUTILS_METRICS_SYSCALLS(4); // Two seeks, read and close
+
+        if (file.fail())
+        {
+            FILEUTILS_METRICS_FAIL();
+            return std::string();
+        }
+
+        else
+        {
+            FILEUTILS_METRICS_BYTES(size);
+            return text;
+        }
+    }
+
+    else
+    {
+        FILEUTILS_METRICS_FAIL();
+        return std::string();
+    }
+}
+
+
+/// <summary>
+/// Write the contents of a bytes buffer to a file
+/// </summary>
+/// <param name="path">The path to the folder where the file should be saved</param>
+/// <param name="filename">The filename, including its extension</param>
+/// <param name="bytes">A pointer to a char array containg the byte buffer</param>
+/// <param name="size">The size of the char array</param>
+/// <returns>True when file could be written, false when an error has occured</returns>
+bool FileUtils::WriteBinaryFile(std::filesystem::path path, char* bytes, int size)
+{
+    FILEUTILS_METRICS_SCOPE(WriteBinaryFile);
+
+    if (!FolderExists(path.parent_path()))
+        return FILEUTILS_METRICS_RESULT(false);
+
+    FILEUTILS_METRICS_SYSCALLS(1);
+    std::ofstream file(path.c_str(), std::ios::binary);
+    if (file.is_open())
+    {
+        file.write(bytes, size);
+        file.close();
+        FILEUTILS_METRICS_SYSCALLS(2); // Write and close
+        FILEUTILS_METRICS_BYTES(size);
+        return FILEUTILS_METRICS_RESULT(!file.fail());
+    }
+
+    else
+        return FILEUTILS_METRICS_RESULT(false);
+}
+
+
+/// <summary>
+/// Reads all the contents of a binary file into a byte buffer
+/// </summary>
+/// <param name="path">The path to the file</param>
+/// <returns>The pointer to the read byte buffer, if an error has occured a nullpointer will be returned. 
+/// Don't forget to delete the buffer when you're done using it. </returns>
+char* FileUtils::ReadBinaryFile(std::filesystem::path path)
+{
+    FILEUTILS_METRICS_SCOPE(ReadBinaryFile);
+
+    if (!FileExists(path))
+    {
+        FILEUTILS_METRICS_FAIL();
+        return nullptr;
+    }
+
+    FILEUTILS_METRICS_SYSCALLS(1);
+    std::ifstream file(path.c_str(), std::ios::binary | std::ios::ate);
+    if (file.is_open())
+    {
+        std::streamsize size = file.tellg();
+        file.seekg(0, std::ios::beg);
+        char* buffer = new char[size];
+        file.read(buffer, size);
+        file.close();
+        FILEUTILS_METRICS_SYSCALLS(4); // Two seeks, read and close
+
+        if (file.fail())
+        {
+            FILEUTILS_METRICS_FAIL();
+            delete[] buffer;
+            return nullptr;
+        }
+
+        else
+        {
+            FILEUTILS_METRICS_BYTES(size);
+            return buffer;
+        }
+    }
+
+    else
+    {
+        FILEUTILS_METRICS_FAIL();
+        return nullptr;
+    }
+}
+
+
+/// <summary>
+/// Get all files inside of folder with a certain file extension. Folders are never returned.
+/// </summary>
+/// <param name="path">The path to the folder in which to search</param>
+/// <param name="extension">The file extension, including the dot. An empty extension finds the files without one</param>
+/// <returns>A unsorted list of paths to the files matching the extension. List is empty if no files could be found</returns>
+std::vector<std::filesystem::path> FileUtils::GetFilesByExtension(std::filesystem::path path, std::string extension)
+{
+    FILEUTILS_METRICS_SCOPE(GetFilesByExtension);
+    std::vector<std::filesystem::path> files;
+
+    if (!FolderExists(path))
+        return files;
+
+    FILEUTILS_METRICS_SYSCALLS(1);
+    for (const auto& entry : std::filesystem::directory_iterator(path))
+    {
+        FILEUTILS_METRICS_ENTRIES(1);
+        if (!std::filesystem::is_directory(entry.status()))
+        {
+            // Files without an extension match an empty one
+            auto filename = GetFilenameView(entry.path());
+            size_t dot = FindExtension(filename);
+            if (dot != std::string_view::npos ? filename.compare(dot, std::string::npos, extension) == 0 : extension.empty())
+            {
+                files.push_back(entry.path());
+            }
+        }
+    }
+
+    return files;
+}
+
+/// <summary>
+/// Get all files inside of a directory which names contain the search string. The search string can be only a part of the full file name
+/// </summary>
+/// <param name="path">The path to the folder which contains the files to search</param>
+/// <param name="filenameContains">The search string which should be contained in the file name</param>
+/// <returns>A unsorted list of paths to the files matching the extension. List is empty if no files could be found</returns>
+std::vector<std::filesystem::path> FileUtils::GetFilesByName(std::filesystem::path path, std::string filenameContains)
+{
+    FILEUTILS_METRICS_SCOPE(GetFilesByName);
+    std::vector<std::filesystem::path> files;
+
+    if (!FolderExists(path))
+        return files;
+
+    FILEUTILS_METRICS_SYSCALLS(1);
+    for (const auto& entry : std::filesystem::directory_iterator(path))
+    {
+        FILEUTILS_METRICS_ENTRIES(1);
+        if (!std::filesystem::is_directory(entry.status()))
+        {
+            if (GetFilenameView(entry.path()).find(filenameContains) != std::string::npos)
+            {
+                files.push_back(entry.path());
+            }
+        }
+    }
+
+    return files;
+}
+
+/// <summary>
+/// Get all sub-folders inside of a folder which contain or match the search string
+/// </summary>
+/// <param name="path">The folder in which to search for the sub-folders</param>
+/// <param name="foldernameContains">The search string which the desired folder names match or contain</param>
+/// <returns>A unsorted list of paths to the folders matching the extension. List is empty if no folders could be found</returns>
+std::vector<std::filesystem::path> FileUtils::GetFoldersByName(std::filesystem::path path, std::string foldernameContains)
+{
+    FILEUTILS_METRICS_SCOPE(GetFoldersByName);
+    std::vector<std::filesystem::path> files;
+
+    if (!FolderExists(path))
+        return files;
+
+    FILEUTILS_METRICS_SYSCALLS(1);
+    for (const auto& entry : std::filesystem::directory_iterator(path))
+    {
+        FILEUTILS_METRICS_ENTRIES(1);
+        if (std::filesystem::is_directory(entry.status()))
+        {
+            if (GetFilenameView(entry.path()).find(foldernameContains) != std::string::npos)
+            {
+                files.push_back(entry.path());
+            }
+        }
+    }
+
+    return files;
+}
+
+/// <summary>
+/// Collects the files or folders below path that match any of the patterns
+/// </summary>
+/// <param name="entries">Receives the number of scanned directory entries</param>
+static std::vector<std::filesystem::path> FindByPattern(const std::filesystem::path& path, const PathMatcher& patterns, bool recursive, bool folders, size_t& entries)
+{
+    std::vector<std::filesystem::path> found;
+
+#ifndef _WIN32
+    // Entries are path / relative, so the relative path is a view into the native string of the entry
+    size_t prefixLength = path.native().size();
+    if (prefixLength > 0 && path.native().back() != '/')
+        prefixLength++;
+#endif
+
+    auto test = [&](const std::filesystem::directory_entry& entry)
+    {
+        // Uses the type cached from the directory listing where the platform provides one, saving a stat per entry
+        std::error_code error;
+        if (entry.is_directory(error) != folders || error)
+            return;
+
+#ifdef _WIN32
+        bool matches = patterns.Matches(patterns.HasPathPatterns() ? entry.path().lexically_relative(path).generic_string() : GetFilenameView(entry.path()));
+#else
+        bool matches = patterns.Matches(std::string_view(entry.path().native()).substr(prefixLength));
+#endif
+        if (matches)
+            found.push_back(entry.path());
+    };
+
+    std::error_code error;
+    if (recursive)
+    {
+        for (std::filesystem::recursive_directory_iterator entry(path, std::filesystem::directory_options::skip_permission_denied, error), end; !error && entry != end; entry.increment(error))
+        {
+            entries++;
+            test(*entry);
+        }
+    }
+    else
+    {
+        for (std::filesystem::directory_iterator entry(path, error), end; !error && entry != end; entry.increment(error))
+        {
+            entries++;
+            test(*entry);
+        }
+    }
+
+    return found;
+}
+
+/// <summary>
+/// Get all files inside of a folder whose names match any of the glob patterns, see PathMatcher.h for the syntax.
+/// All patterns are tested in one pass over each name, so searching for hundreds of patterns costs little more than for one.
+/// </summary>
+/// <param name="path">The folder in which to search</param>
+/// <param name="patterns">The compiled patterns. Patterns with a '/' are matched against the path relative to the folder, e.g. "renders/**/*.exr"</param>
+/// <param name="recursive">Also search all sub-folders</param>
+/// <returns>A unsorted list of paths to the matching files. List is empty if no files could be found</returns>
+std::vector<std::filesystem::path> FileUtils::GetFilesByPattern(std::filesystem::path path, const PathMatcher& patterns, bool recursive)
+{
+    FILEUTILS_METRICS_SCOPE(GetFilesByPattern);
+
+    if (!FolderExists(path))
+        return std::vector<std::filesystem::path>();
+
+    size_t entries = 0;
+    std::vector<std::filesystem::path> found = FindByPattern(path, patterns, recursive, false, entries);
+    FILEUTILS_METRICS_SYSCALLS(1);
+    FILEUTILS_METRICS_ENTRIES(entries);
+    return found;
+}
+
+/// <summary>
+/// Get all sub-folders inside of a folder whose names match any of the glob patterns, see PathMatcher.h for the syntax
+/// </summary>
+/// <param name="path">The folder in which to search</param>
+/// <param name="patterns">The compiled patterns. Patterns with a '/' are matched against the path relative to the folder</param>
+/// <param name="recursive">Also search all sub-folders</param>
+/// <returns>A unsorted list of paths to the matching folders. List is empty if no folders could be found</returns>
+std::vector<std::filesystem::path> FileUtils::GetFoldersByPattern(std::filesystem::path path, const PathMatcher& patterns, bool recursive)
+{
+    FILEUTILS_METRICS_SCOPE(GetFoldersByPattern);
+
+    if (!FolderExists(path))
+        return std::vector<std::filesystem::path>();
+
+    size_t entries = 0;
+    std::vector<std::filesystem::path> found = FindByPattern(path, patterns, recursive, true, entries);
+    FILEUTILS_METRICS_SYSCALLS(1);
+    FILEUTILS_METRICS_ENTRIES(entries);
+    return found;
+}
+
+std::vector<std::filesystem::path> FileUtils::SortPathsByNumericValue(std::vector<std::filesystem::path> paths, bool ascending)
+{
+    //ToDo
+    throw std::runtime_error("Function not implemented");
+    return std::vector<std::filesystem::path>();
+}
+
+
+/// <summary>
+/// Get the name of the folder which the path points to
+/// </summary>
+/// <param name="pathToFolder">The path to a folder</param>
+/// <returns>The name of the folder</returns>
+std::string FileUtils::GetFolderName(std::filesystem::path pathToFolder)
+{
+    if (std::filesystem::is_directory(pathToFolder))
+        return pathToFolder.filename().string();
+    else
+        return pathToFolder.parent_path().filename().string();
+}
+
+
+/// <summary>
+/// If the filename contains a numeric value, the value will be returned as int.
+/// The number can be anywhere in the filename, but can only be a positive integer.
+/// If there are multiple distinct numbers in a file, this function will return
+/// the numbers concatted (14name99,jpg -> 1499) 
+/// </summary>
+/// <param name="filename">The filename, can be with or without extension</param>
+/// <returns>The value as a positive integer, -1 if there is no number inside of the file name</returns>
+int FileUtils::GetIntFromFilename(std::string filename)
+{
+    std::string intAsString;
+
+    if (filename.empty())
+        return -1;
+
+    try
+    {
+        // Compiled once, building a std::regex is far more expensive than running it
+        static const std::regex numberPattern("[^0-9]*([0-9]+).*");
+        intAsString = std::regex_replace(filename, numberPattern, std::string("$1"));
+    }
+
+    catch (...)
+    {
+        return -1;
+    }
+
+    if (intAsString.empty() || intAsString.size() < 1)
+        return -1;
+
+    return std::stoi(intAsString);
+}
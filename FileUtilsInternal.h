@@ -0,0 +1,83 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+// Helpers shared by the translation units of the library, not part of the public interface.
+
+// POSIX system calls are available (Linux, macOS, BSDs). This is a platform check, not a feature detected by CMake,
+// so it does not use the FILEUTILS_HAVE_ prefix.
+#if defined(__unix__) || defined(__APPLE__)
+#define FILEUTILS_POSIX 1
+#include <sys/stat.h>
+#endif
+
+// Metrics hooks, see FileUtilsMetrics.h. They expand to nothing unless FILEUTILS_ENABLE_METRICS is defined.
+#ifdef FILEUTILS_ENABLE_METRICS
+#include "FileUtilsMetrics.h"
+#define FILEUTILS_METRICS_SCOPE(operation) FileUtilsMetrics::Scope fileUtilsMetrics(FileUtilsMetrics::Operation::operation)
+#define FILEUTILS_METRICS_RESULT(success) fileUtilsMetrics.Result(success)
+#define FILEUTILS_METRICS_FAIL() fileUtilsMetrics.Fail()
+#define FILEUTILS_METRICS_EXCEPTION() fileUtilsMetrics.Exception()
+#define FILEUTILS_METRICS_BYTES(count) fileUtilsMetrics.AddBytes(count)
+#define FILEUTILS_METRICS_SYSCALLS(count) fileUtilsMetrics.AddSyscalls(count)
+#define FILEUTILS_METRICS_ENTRIES(count) fileUtilsMetrics.AddEntries(count)
+#else
+#define FILEUTILS_METRICS_SCOPE(operation)
+#define FILEUTILS_METRICS_RESULT(success) (success)
+#define FILEUTILS_METRICS_FAIL()
+#define FILEUTILS_METRICS_EXCEPTION()
+#define FILEUTILS_METRICS_BYTES(count)
+#define FILEUTILS_METRICS_SYSCALLS(count)
+#define FILEUTILS_METRICS_ENTRIES(count)
+#endif
+
+
+// The file name part of a path without allocating, as a view into the native path string.
+// Windows paths are wide strings, there the name has to be converted and is returned as a std::string.
+#ifdef _WIN32
+inline std::string GetFilenameView(const std::filesystem::path& path)
+{
+    return path.filename().string();
+}
+#else
+inline std::string_view GetFilenameView(const std::filesystem::path& path)
+{
+    std::string_view native = path.native();
+    size_t slash = native.find_last_of('/');
+    return slash == std::string_view::npos ? native : native.substr(slash + 1);
+}
+#endif
+
+// Position of the dot that starts the extension of a file name, npos if there is none. Same rules as
+// std::filesystem::path::extension: the last dot starts it, unless it is the first character, "." and ".." have none.
+inline size_t FindExtension(std::string_view filename)
+{
+    if (filename == "." || filename == "..")
+        return std::string_view::npos;
+
+    size_t dot = filename.find_last_of('.');
+    return dot == 0 ? std::string_view::npos : dot;
+}
+
+// A file time in nanoseconds since the Unix epoch. C++17 has no conversion between the file clock and the system clock,
+// so this goes through "now" of both clocks.
+inline int64_t FileTimeToUnixNs(std::filesystem::file_time_type fileTime)
+{
+    auto systemTime = std::chrono::system_clock::now() + std::chrono::duration_cast<std::chrono::system_clock::duration>(fileTime - std::filesystem::file_time_type::clock::now());
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(systemTime.time_since_epoch()).count();
+}
+
+#ifdef FILEUTILS_POSIX
+// Modification time of a stat result in nanoseconds since the Unix epoch
+inline int64_t GetModificationTimeNs(const struct stat& info)
+{
+#ifdef __APPLE__
+    return (int64_t)info.st_mtimespec.tv_sec * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+    return (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+}
+#endif
@@ -0,0 +1,124 @@
+#include "FileUtilsMetrics.h"
+
+
+std::array<FileUtilsMetrics::Counters, (size_t)FileUtilsMetrics::Operation::Count> FileUtilsMetrics::counters;
+std::mutex FileUtilsMetrics::sinkMutex;
+std::shared_ptr<FileUtilsMetrics::Sink> FileUtilsMetrics::sink;
+std::atomic<bool> FileUtilsMetrics::hasSink{ false };
+
+/// <summary>
+/// Get the counters accumulated for an operation since the start of the process or the last Reset()
+/// </summary>
+/// <param name="operation">The operation</param>
+/// <returns>A copy of the counters. Counters are read one by one, so a snapshot taken while calls are running is not atomic as a whole.</returns>
+FileUtilsMetrics::Snapshot FileUtilsMetrics::GetSnapshot(Operation operation)
+{
+    const Counters& source = counters[(size_t)operation];
+    Snapshot snapshot;
+    snapshot.calls = source.calls.load(std::memory_order_relaxed);
+    snapshot.failures = source.failures.load(std::memory_order_relaxed);
+    snapshot.exceptions = source.exceptions.load(std::memory_order_relaxed);
+    snapshot.bytes = source.bytes.load(std::memory_order_relaxed);
+    snapshot.syscalls = source.syscalls.load(std::memory_order_relaxed);
+    snapshot.entriesScanned = source.entriesScanned.load(std::memory_order_relaxed);
+    snapshot.totalLatencyNs = source.totalLatencyNs.load(std::memory_order_relaxed);
+
+    for (size_t i = 0; i < LatencyBucketCount; i++)
+        snapshot.latencyHistogram[i] = source.latencyHistogram[i].load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+/// <summary>
+/// Get the name of an operation, matching the name of the FileUtils function
+/// </summary>
+const char* FileUtilsMetrics::GetName(Operation operation)
+{
+    static const char* names[] =
+    {
+        "FolderExists", "CreateNewFolder", "DeleteFolder", "RenameFolder", "MoveFolder", "CopyFolder",
+        "FileExists", "DeleteFile", "RenameFile", "MoveFile", "CopyFile",
+        "WriteTextFile", "WriteBinaryFile", "ReadBinaryFile", "ReadTextFile",
+        "GetFilesByExtension", "GetFilesByName", "GetFoldersByName", "GetFilesByPattern", "GetFoldersByPattern",
+        "GetMetadata", "GetFolderMetadata", "ScanTreeStats"
+    };
+
+    static_assert(sizeof(names) / sizeof(names[0]) == (size_t)Operation::Count, "Every operation needs a name");
+
+    if (operation >= Operation::Count)
+        return "Unknown";
+
+    return names[(size_t)operation];
+}
+
+/// <summary>
+/// Sets all counters back to zero
+/// </summary>
+void FileUtilsMetrics::Reset()
+{
+    for (Counters& target : counters)
+    {
+        target.calls = 0;
+        target.failures = 0;
+        target.exceptions = 0;
+        target.bytes = 0;
+        target.syscalls = 0;
+        target.entriesScanned = 0;
+        target.totalLatencyNs = 0;
+
+        for (auto& bucket : target.latencyHistogram)
+            bucket = 0;
+    }
+}
+
+/// <summary>
+/// Installs a callback which receives every instrumented call after it finished. The sink is called on the thread that made the call,
+/// so it has to be thread safe and should be fast. Pass an empty function to remove the sink.
+/// </summary>
+/// <param name="newSink">The callback</param>
+void FileUtilsMetrics::SetSink(Sink newSink)
+{
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    sink = newSink ? std::make_shared<Sink>(std::move(newSink)) : nullptr;
+    hasSink.store(sink != nullptr, std::memory_order_release);
+}
+
+void FileUtilsMetrics::Submit(const Record& record)
+{
+    Counters& target = counters[(size_t)record.operation];
+    target.calls.fetch_add(1, std::memory_order_relaxed);
+    target.bytes.fetch_add(record.bytes, std::memory_order_relaxed);
+    target.syscalls.fetch_add(record.syscalls, std::memory_order_relaxed);
+    target.entriesScanned.fetch_add(record.entriesScanned, std::memory_order_relaxed);
+    target.exceptions.fetch_add(record.exceptions, std::memory_order_relaxed);
+    target.totalLatencyNs.fetch_add(record.latencyNs, std::memory_order_relaxed);
+
+    if (!record.success)
+        target.failures.fetch_add(1, std::memory_order_relaxed);
+
+    size_t bucket = 0;
+    for (uint64_t latency = record.latencyNs; latency > 1 && bucket + 1 < LatencyBucketCount; latency >>= 1)
+        bucket++;
+
+    target.latencyHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    if (!hasSink.load(std::memory_order_acquire))
+        return;
+
+    std::shared_ptr<Sink> currentSink;
+    {
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        currentSink = sink;
+    }
+
+    // Called from the destructor of Scope, an exception escaping from the sink would terminate the process
+    try
+    {
+        if (currentSink)
+            (*currentSink)(record);
+    }
+
+    catch (...)
+    {
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+
+// Opt-in instrumentation for the FileUtils functions that touch the file system.
+// Define FILEUTILS_ENABLE_METRICS when compiling the library (CMake option FILEUTILS_ENABLE_METRICS) to turn it on.
+// Without the define the FILEUTILS_METRICS_* macros in FileUtilsInternal.h expand to nothing and this header is not even included.
+//
+// Per operation it keeps the number of calls, failures, caught exceptions, bytes read/written, file system calls
+// and directory entries scanned, plus a log2 latency histogram.
+// The file system call counts are estimates: a std::filesystem call counts as one and a stream operation as the calls
+// it usually makes (open, seeks, read/write, close), whatever the standard library really issues. Only the overloads
+// taking FileIOOptions count the system calls they make themselves.
+// A sink callback can be installed to receive every single call, e.g. to forward it to a metrics exporter.
+//
+// Thread safety: all counters are atomics, every function of this class may be called from any thread.
+// Scope is defined inline below since it sits in every instrumented call, the rest lives in FileUtilsMetrics.cpp.
+
+class FileUtilsMetrics
+{
+public:
+    enum class Operation
+    {
+        FolderExists,
+        CreateNewFolder,
+        DeleteFolder,
+        RenameFolder,
+        MoveFolder,
+        CopyFolder,
+        FileExists,
+        DeleteFile,
+        RenameFile,
+        MoveFile,
+        CopyFile,
+        WriteTextFile,
+        WriteBinaryFile,
+        ReadBinaryFile,
+        ReadTextFile,
+        GetFilesByExtension,
+        GetFilesByName,
+        GetFoldersByName,
+        GetFilesByPattern,
+        GetFoldersByPattern,
+        GetMetadata,
+        GetFolderMetadata,
+        ScanTreeStats,
+        Count
+    };
+
+    // Bucket i counts calls with a latency in [2^i, 2^(i+1)) nanoseconds, the last bucket also holds everything slower
+    static constexpr size_t LatencyBucketCount = 40;
+
+    // One finished call, handed to the sink
+    struct Record
+    {
+        Operation operation;
+        bool success;
+        uint64_t latencyNs;
+        uint64_t bytes;
+        uint64_t syscalls;
+        uint64_t entriesScanned;
+        uint64_t exceptions;
+    };
+
+    // Accumulated counters of one operation
+    struct Snapshot
+    {
+        uint64_t calls = 0;
+        uint64_t failures = 0;
+        uint64_t exceptions = 0;
+        uint64_t bytes = 0;
+        uint64_t syscalls = 0;
+        uint64_t entriesScanned = 0;
+        uint64_t totalLatencyNs = 0;
+        std::array<uint64_t, LatencyBucketCount> latencyHistogram{};
+    };
+
+    using Sink = std::function<void(const Record&)>;
+
+    // Measures one call, created at the top of an instrumented function through FILEUTILS_METRICS_SCOPE
+    class Scope
+    {
+    public:
+        explicit Scope(Operation operation);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        bool Result(bool success);
+        void Fail();
+        void Exception();
+        void AddBytes(uint64_t count);
+        void AddSyscalls(uint64_t count);
+        void AddEntries(uint64_t count);
+
+    private:
+        Record record;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    static Snapshot GetSnapshot(Operation operation);
+    static const char* GetName(Operation operation);
+    static void Reset();
+    static void SetSink(Sink sink);
+
+private:
+    struct Counters
+    {
+        std::atomic<uint64_t> calls{ 0 };
+        std::atomic<uint64_t> failures{ 0 };
+        std::atomic<uint64_t> exceptions{ 0 };
+        std::atomic<uint64_t> bytes{ 0 };
+        std::atomic<uint64_t> syscalls{ 0 };
+        std::atomic<uint64_t> entriesScanned{ 0 };
+        std::atomic<uint64_t> totalLatencyNs{ 0 };
+        std::array<std::atomic<uint64_t>, LatencyBucketCount> latencyHistogram{};
+    };
+
+    static void Submit(const Record& record);
+
+    static std::array<Counters, (size_t)Operation::Count> counters;
+    static std::mutex sinkMutex;
+    static std::shared_ptr<Sink> sink;
+    static std::atomic<bool> hasSink;
+};
+
+
+inline FileUtilsMetrics::Scope::Scope(Operation operation) : record{ operation, true, 0, 0, 0, 0, 0 }, start(std::chrono::steady_clock::now())
+{
+}
+
+inline FileUtilsMetrics::Scope::~Scope()
+{
+    record.latencyNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    Submit(record);
+}
+
+/// <summary>
+/// Records the outcome of the call and passes it through, used as "return FILEUTILS_METRICS_RESULT(value);"
+/// </summary>
+inline bool FileUtilsMetrics::Scope::Result(bool success)
+{
+    if (!success)
+        record.success = false;
+
+    return success;
+}
+
+inline void FileUtilsMetrics::Scope::Fail()
+{
+    record.success = false;
+}
+
+/// <summary>
+/// Records a caught exception, the call counts as failed
+/// </summary>
+inline void FileUtilsMetrics::Scope::Exception()
+{
+    record.exceptions++;
+    record.success = false;
+}
+
+inline void FileUtilsMetrics::Scope::AddBytes(uint64_t count)
+{
+    record.bytes += count;
+}
+
+inline void FileUtilsMetrics::Scope::AddSyscalls(uint64_t count)
+{
+    record.syscalls += count;
+}
+
+inline void FileUtilsMetrics::Scope::AddEntries(uint64_t count)
+{
+    record.entriesScanned += count;
+}
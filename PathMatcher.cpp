@@ -0,0 +1,560 @@
+#include "PathMatcher.h"
+#include <algorithm>
+
+
+namespace
+{
+    // Active NFA states while matching, one bit per token position plus the accepting state
+    struct StateSet
+    {
+        uint64_t words[4] = {};
+
+        void Set(size_t state) { words[state >> 6] |= 1ull << (state & 63); }
+        bool Test(size_t state) const { return (words[state >> 6] >> (state & 63)) & 1; }
+        bool Empty() const { return !(words[0] | words[1] | words[2] | words[3]); }
+    };
+
+    // Progress of one pattern during a scan: which of its literals were seen, and whether it was verified already
+    struct PatternVisit
+    {
+        uint32_t generation = 0;
+        bool verified = false;
+        uint64_t seenLiterals = 0;
+    };
+}
+
+// Reused across scans, an entry is only valid while its generation is the current one
+static thread_local std::vector<PatternVisit> patternVisits;
+static thread_local uint32_t visitGeneration = 0;
+
+
+static void SetClassRange(std::array<uint64_t, 4>& charClass, unsigned char first, unsigned char last)
+{
+    for (unsigned int c = first; c <= last; c++)
+        charClass[c >> 6] |= 1ull << (c & 63);
+}
+
+/// <summary>
+/// Parses a character class like [a-z0-9] or [!abc] starting at the '['
+/// </summary>
+/// <param name="source">The pattern</param>
+/// <param name="position">Index of the '['. Set to the index after the closing ']' on success</param>
+/// <param name="charClass">Receives the set of matching characters, never containing '/'</param>
+/// <returns>True if the class was parsed, false if there is no closing ']'</returns>
+static bool ParseCharClass(const std::string& source, size_t& position, std::array<uint64_t, 4>& charClass)
+{
+    size_t i = position + 1;
+    bool negate = i < source.size() && (source[i] == '!' || source[i] == '^');
+    if (negate)
+        i++;
+
+    charClass.fill(0);
+    size_t first = i;
+
+    // A ']' right at the start is a member, not the end of the class
+    while (i < source.size() && (source[i] != ']' || i == first))
+    {
+        unsigned char low = (unsigned char)source[i];
+        if (low == '\\' && i + 1 < source.size())
+            low = (unsigned char)source[++i];
+
+        unsigned char high = low;
+        if (i + 2 < source.size() && source[i + 1] == '-' && source[i + 2] != ']')
+        {
+            i += 2;
+            high = (unsigned char)source[i];
+            if (high == '\\' && i + 1 < source.size())
+                high = (unsigned char)source[++i];
+        }
+
+        if (low <= high)
+            SetClassRange(charClass, low, high);
+        i++;
+    }
+
+    if (i >= source.size())
+        return false;
+
+    if (negate)
+    {
+        for (uint64_t& word : charClass)
+            word = ~word;
+    }
+
+    charClass['/' >> 6] &= ~(1ull << ('/' & 63));
+    position = i + 1;
+    return true;
+}
+
+
+/// <summary>
+/// Turns a glob into tokens and finds its literals and shape
+/// </summary>
+/// <param name="source">The glob</param>
+/// <param name="pattern">Receives the compiled pattern</param>
+/// <returns>False if the pattern has more than MaxTokens tokens</returns>
+bool PathMatcher::Compile(const std::string& source, Pattern& pattern)
+{
+    std::vector<Token>& tokens = pattern.tokens;
+    size_t i = 0;
+
+    while (i < source.size())
+    {
+        char c = source[i];
+
+        if (c == '*')
+        {
+            size_t end = i;
+            while (end < source.size() && source[end] == '*')
+                end++;
+
+            TokenType type = TokenType::Star;
+            if (end - i > 1)
+            {
+                type = TokenType::GlobStar;
+                if (end < source.size() && source[end] == '/')
+                {
+                    type = TokenType::GlobStarSlash;
+                    end++;
+                }
+            }
+
+            // A star right after another star adds nothing, only keep the one that matches more
+            if (!tokens.empty() && (tokens.back().type == TokenType::Star || tokens.back().type == TokenType::GlobStar) && type != TokenType::GlobStarSlash)
+            {
+                if (type == TokenType::GlobStar)
+                    tokens.back().type = TokenType::GlobStar;
+            }
+            else
+            {
+                tokens.push_back({ type, 0, 0 });
+                if (type == TokenType::GlobStarSlash)
+                    tokens.push_back({ TokenType::GlobStarSlashLoop, 0, 0 });
+            }
+
+            i = end;
+            continue;
+        }
+
+        if (c == '?')
+        {
+            tokens.push_back({ TokenType::AnyChar, 0, 0 });
+            i++;
+            continue;
+        }
+
+        if (c == '[')
+        {
+            std::array<uint64_t, 4> charClass;
+            if (ParseCharClass(source, i, charClass))
+            {
+                tokens.push_back({ TokenType::CharClass, 0, (uint16_t)pattern.charClasses.size() });
+                pattern.charClasses.push_back(charClass);
+                continue;
+            }
+        }
+
+        if (c == '\\' && i + 1 < source.size())
+            c = source[++i];
+
+        tokens.push_back({ TokenType::Literal, c, 0 });
+        i++;
+    }
+
+    if (tokens.size() > MaxTokens)
+        return false;
+
+    // Runs of literals, every match has to contain all of them. The longest one is used by the shape shortcuts.
+    size_t bestStart = 0, bestLength = 0;
+    for (size_t start = 0; start < tokens.size();)
+    {
+        if (tokens[start].type != TokenType::Literal)
+        {
+            start++;
+            continue;
+        }
+
+        size_t end = start;
+        while (end < tokens.size() && tokens[end].type == TokenType::Literal)
+            end++;
+
+        if (pattern.literals.size() < MaxLiterals)
+        {
+            pattern.literals.emplace_back();
+            for (size_t t = start; t < end; t++)
+                pattern.literals.back().push_back(tokens[t].literal);
+        }
+
+        if (end - start > bestLength)
+        {
+            bestStart = start;
+            bestLength = end - start;
+        }
+
+        start = end;
+    }
+
+    for (size_t t = bestStart; t < bestStart + bestLength; t++)
+        pattern.literal.push_back(tokens[t].literal);
+
+    pattern.allLiterals = pattern.literals.size() == MaxLiterals ? ~0ull : (1ull << pattern.literals.size()) - 1;
+
+    // The shortcuts for stars are only valid for file names, a star does not match the '/' in a relative path
+    size_t count = tokens.size();
+    bool isPathPattern = source.find('/') != std::string::npos;
+    bool leadingStar = count > 0 && tokens.front().type == TokenType::Star;
+    bool trailingStar = count > 1 && tokens.back().type == TokenType::Star;
+    size_t literalCount = count - leadingStar - trailingStar;
+
+    if (bestLength > 0 && bestLength == literalCount)
+    {
+        if (!leadingStar && !trailingStar)
+            pattern.shape = Shape::Exact;
+        else if (!isPathPattern)
+            pattern.shape = leadingStar ? (trailingStar ? Shape::Contains : Shape::Suffix) : Shape::Prefix;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Runs the NFA of a pattern over the text. All states are tracked at once, so this never backtracks and takes
+/// at most text length * token count steps.
+/// </summary>
+bool PathMatcher::MatchTokens(const Pattern& pattern, std::string_view text)
+{
+    const std::vector<Token>& tokens = pattern.tokens;
+    size_t accept = tokens.size();
+
+    // Stars may match nothing, so the state after a star is active whenever the star is.
+    // "**/" either matches nothing and skips its loop, or enters the loop which only leaves after a '/'.
+    auto close = [&tokens, accept](StateSet& states)
+    {
+        for (size_t i = 0; i < accept; i++)
+        {
+            if (!states.Test(i))
+                continue;
+
+            TokenType type = tokens[i].type;
+            if (type == TokenType::Star || type == TokenType::GlobStar || type == TokenType::GlobStarSlash)
+                states.Set(i + 1);
+            if (type == TokenType::GlobStarSlash)
+                states.Set(i + 2);
+        }
+    };
+
+    StateSet current;
+    current.Set(0);
+    close(current);
+
+    for (char c : text)
+    {
+        StateSet next;
+        unsigned char byte = (unsigned char)c;
+
+        for (size_t i = 0; i < accept; i++)
+        {
+            if (!current.Test(i))
+                continue;
+
+            const Token& token = tokens[i];
+            switch (token.type)
+            {
+            case TokenType::Literal:
+                if (c == token.literal)
+                    next.Set(i + 1);
+                break;
+            case TokenType::AnyChar:
+                if (c != '/')
+                    next.Set(i + 1);
+                break;
+            case TokenType::CharClass:
+                if ((pattern.charClasses[token.charClass][byte >> 6] >> (byte & 63)) & 1)
+                    next.Set(i + 1);
+                break;
+            case TokenType::Star:
+                if (c != '/')
+                    next.Set(i);
+                break;
+            case TokenType::GlobStar:
+                next.Set(i);
+                break;
+            case TokenType::GlobStarSlash:
+                break;
+            case TokenType::GlobStarSlashLoop:
+                next.Set(i);
+                if (c == '/')
+                    next.Set(i + 1);
+                break;
+            }
+        }
+
+        if (next.Empty())
+            return false;
+
+        close(next);
+        current = next;
+    }
+
+    return current.Test(accept);
+}
+
+bool PathMatcher::Verify(const Pattern& pattern, std::string_view text)
+{
+    std::string_view literal = pattern.literal;
+
+    switch (pattern.shape)
+    {
+    case Shape::Exact:
+        return text == literal;
+    case Shape::Prefix:
+        return text.size() >= literal.size() && text.compare(0, literal.size(), literal) == 0;
+    case Shape::Suffix:
+        return text.size() >= literal.size() && text.compare(text.size() - literal.size(), literal.size(), literal) == 0;
+    case Shape::Contains:
+        return text.find(literal) != std::string_view::npos;
+    default:
+        return MatchTokens(pattern, text);
+    }
+}
+
+/// <summary>
+/// Builds the Aho-Corasick automaton over the literal runs of all patterns in the group. The goto function is
+/// completed with the fail links up front, so matching is a single table lookup per character.
+/// </summary>
+void PathMatcher::BuildAutomaton(PatternGroup& group)
+{
+    Automaton& automaton = group.automaton;
+    automaton = Automaton();
+    group.withoutLiteral.clear();
+
+    auto addNode = [&automaton]()
+    {
+        automaton.transitions.emplace_back();
+        automaton.transitions.back().fill(-1);
+        automaton.outputLinks.push_back(-1);
+        automaton.outputs.emplace_back();
+        return (int32_t)automaton.transitions.size() - 1;
+    };
+
+    for (size_t i = 0; i < group.patterns.size(); i++)
+    {
+        const std::vector<std::string>& literals = group.patterns[i].literals;
+        if (literals.empty())
+        {
+            group.withoutLiteral.push_back((uint32_t)i);
+            continue;
+        }
+
+        if (automaton.transitions.empty())
+            addNode();
+
+        for (size_t l = 0; l < literals.size(); l++)
+        {
+            int32_t node = 0;
+            for (char c : literals[l])
+            {
+                int32_t next = automaton.transitions[node][(unsigned char)c];
+                if (next < 0)
+                {
+                    next = addNode();
+                    automaton.transitions[node][(unsigned char)c] = next;
+                }
+                node = next;
+            }
+
+            automaton.outputs[node].push_back({ (uint32_t)i, (uint32_t)l });
+        }
+    }
+
+    if (automaton.transitions.empty())
+        return;
+
+    // Breadth first, so the fail target of a node (always shallower) is complete before the node itself
+    std::vector<int32_t> fail(automaton.transitions.size(), 0);
+    std::vector<int32_t> queue;
+
+    for (int32_t& next : automaton.transitions[0])
+    {
+        if (next < 0)
+            next = 0;
+        else
+            queue.push_back(next);
+    }
+
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        int32_t node = queue[head];
+        int32_t failNode = fail[node];
+        automaton.outputLinks[node] = automaton.outputs[failNode].empty() ? automaton.outputLinks[failNode] : failNode;
+
+        for (size_t c = 0; c < 256; c++)
+        {
+            int32_t next = automaton.transitions[node][c];
+            if (next < 0)
+            {
+                automaton.transitions[node][c] = automaton.transitions[failNode][c];
+            }
+            else
+            {
+                fail[next] = automaton.transitions[failNode][c];
+                queue.push_back(next);
+            }
+        }
+    }
+}
+
+/// <summary>
+/// Calls onMatch for every pattern of the group that matches the text, until it returns true
+/// </summary>
+/// <returns>True if onMatch stopped the search</returns>
+template <typename OnMatch>
+bool PathMatcher::ForEachMatch(const PatternGroup& group, std::string_view text, OnMatch onMatch)
+{
+    for (uint32_t i : group.withoutLiteral)
+    {
+        if (Verify(group.patterns[i], text) && onMatch(group.patterns[i]))
+            return true;
+    }
+
+    const Automaton& automaton = group.automaton;
+    if (automaton.transitions.empty())
+        return false;
+
+    if (patternVisits.size() < group.patterns.size())
+        patternVisits.resize(group.patterns.size());
+
+    if (++visitGeneration == 0)
+    {
+        std::fill(patternVisits.begin(), patternVisits.end(), PatternVisit());
+        visitGeneration = 1;
+    }
+
+    int32_t state = 0;
+    for (char c : text)
+    {
+        state = automaton.transitions[state][(unsigned char)c];
+
+        int32_t node = automaton.outputs[state].empty() ? automaton.outputLinks[state] : state;
+        for (; node >= 0; node = automaton.outputLinks[node])
+        {
+            for (const Output& output : automaton.outputs[node])
+            {
+                PatternVisit& visit = patternVisits[output.pattern];
+                if (visit.generation != visitGeneration)
+                    visit = { visitGeneration, false, 0 };
+
+                const Pattern& pattern = group.patterns[output.pattern];
+                visit.seenLiterals |= 1ull << output.literal;
+                if (visit.verified || visit.seenLiterals != pattern.allLiterals)
+                    continue;
+
+                // Only now that every literal was seen the pattern can match at all
+                visit.verified = true;
+                if (Verify(pattern, text) && onMatch(pattern))
+                    return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+/// <summary>
+/// Compiles all patterns at once, which is much cheaper than adding them one by one
+/// </summary>
+/// <param name="patterns">The globs. Patterns that can not be compiled (more than 255 tokens) are skipped, compare GetPatternCount</param>
+PathMatcher::PathMatcher(const std::vector<std::string>& patterns)
+{
+    for (const std::string& source : patterns)
+    {
+        Pattern pattern;
+        if (!Compile(source, pattern))
+            continue;
+
+        pattern.index = patternCount++;
+        (source.find('/') != std::string::npos ? pathPatterns : namePatterns).patterns.push_back(std::move(pattern));
+    }
+
+    BuildAutomaton(namePatterns);
+    BuildAutomaton(pathPatterns);
+}
+
+/// <summary>
+/// Compiles a pattern and adds it to the set. Rebuilds the automaton, prefer the constructor for many patterns.
+/// </summary>
+/// <param name="pattern">The glob</param>
+/// <returns>False if the pattern could not be compiled, because it has more than 255 tokens</returns>
+bool PathMatcher::AddPattern(const std::string& pattern)
+{
+    Pattern compiled;
+    if (!Compile(pattern, compiled))
+        return false;
+
+    compiled.index = patternCount++;
+    PatternGroup& group = pattern.find('/') != std::string::npos ? pathPatterns : namePatterns;
+    group.patterns.push_back(std::move(compiled));
+    BuildAutomaton(group);
+    return true;
+}
+
+size_t PathMatcher::GetPatternCount() const
+{
+    return patternCount;
+}
+
+/// <summary>
+/// Whether any pattern contains a '/' and so needs the whole relative path instead of the file name
+/// </summary>
+bool PathMatcher::HasPathPatterns() const
+{
+    return !pathPatterns.patterns.empty();
+}
+
+/// <summary>
+/// Check if any pattern matches
+/// </summary>
+/// <param name="relativePath">The '/' separated path relative to the searched folder, or only a file name</param>
+/// <returns>True if at least one pattern matches</returns>
+bool PathMatcher::Matches(std::string_view relativePath) const
+{
+    auto stop = [](const Pattern&) { return true; };
+
+    if (!namePatterns.patterns.empty())
+    {
+        size_t slash = relativePath.find_last_of('/');
+        std::string_view name = slash == std::string_view::npos ? relativePath : relativePath.substr(slash + 1);
+        if (ForEachMatch(namePatterns, name, stop))
+            return true;
+    }
+
+    return !pathPatterns.patterns.empty() && ForEachMatch(pathPatterns, relativePath, stop);
+}
+
+/// <summary>
+/// Get every pattern that matches
+/// </summary>
+/// <param name="relativePath">The '/' separated path relative to the searched folder, or only a file name</param>
+/// <param name="matches">Receives the indices of the matching patterns in the order they were added, sorted ascending. Cleared first</param>
+void PathMatcher::GetMatches(std::string_view relativePath, std::vector<size_t>& matches) const
+{
+    matches.clear();
+    auto collect = [&matches](const Pattern& pattern)
+    {
+        matches.push_back(pattern.index);
+        return false;
+    };
+
+    if (!namePatterns.patterns.empty())
+    {
+        size_t slash = relativePath.find_last_of('/');
+        std::string_view name = slash == std::string_view::npos ? relativePath : relativePath.substr(slash + 1);
+        ForEachMatch(namePatterns, name, collect);
+    }
+
+    if (!pathPatterns.patterns.empty())
+        ForEachMatch(pathPatterns, relativePath, collect);
+
+    std::sort(matches.begin(), matches.end());
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+// Compiled glob patterns, many of them matched in a single pass over a name.
+//
+// Syntax:   *       any run of characters except '/'
+//           **      any run of characters including '/'. "**/" also matches nothing, so "a/**/b" matches "a/b"
+//           ?       any single character except '/'
+//           [a-z0-9] [!abc] [^abc]   character classes, ranges and negation
+//           \x      the character x itself
+// Patterns without a '/' are matched against the file name only, patterns with a '/' against the whole relative path.
+// Matching is case sensitive and works on '/' separated paths.
+//
+// Every pattern gets compiled into a small NFA. Additionally the literal runs of every pattern go into one
+// Aho-Corasick automaton, so a name is scanned once for all patterns and only the patterns whose literals all occur
+// in it are run at all. Matching does not allocate, apart from a per thread scratch buffer that grows once.
+//
+// Thread safety: a PathMatcher may be used for matching from any number of threads at once. AddPattern must not
+// run concurrently with anything else on the same instance.
+
+class PathMatcher
+{
+public:
+    PathMatcher() = default;
+    explicit PathMatcher(const std::vector<std::string>& patterns);
+
+    bool AddPattern(const std::string& pattern);
+    size_t GetPatternCount() const;
+    bool HasPathPatterns() const;
+
+    bool Matches(std::string_view relativePath) const;
+    void GetMatches(std::string_view relativePath, std::vector<size_t>& matches) const;
+
+private:
+    static const size_t MaxTokens = 255;
+    static const size_t MaxLiterals = 64;   // Literal runs of a pattern used by the prefilter, further runs are only checked by the NFA
+
+    enum class TokenType : uint8_t
+    {
+        Literal,
+        AnyChar,
+        CharClass,
+        Star,
+        GlobStar,
+        GlobStarSlash,      // Entry of "**/", consumes nothing and either skips it or enters the loop
+        GlobStarSlashLoop   // Body of "**/", consumes any character and can only leave right after a '/'
+    };
+
+    struct Token
+    {
+        TokenType type;
+        char literal;
+        uint16_t charClass;     // Index into Pattern::charClasses
+    };
+
+    // Patterns of a few common shapes are checked with plain string compares instead of the NFA
+    enum class Shape : uint8_t
+    {
+        General,
+        Exact,      // abc
+        Prefix,     // abc*
+        Suffix,     // *abc
+        Contains    // *abc*
+    };
+
+    struct Pattern
+    {
+        size_t index;           // Position in the order the patterns were added
+        std::vector<Token> tokens;
+        std::vector<std::array<uint64_t, 4>> charClasses;
+        std::string literal;    // Longest run of literal characters, used by the shape shortcuts
+        std::vector<std::string> literals;  // All runs of literal characters, every match contains each of them
+        uint64_t allLiterals = 0;           // One bit per entry of literals
+        Shape shape = Shape::General;
+    };
+
+    struct Output
+    {
+        uint32_t pattern;       // Index into PatternGroup::patterns
+        uint32_t literal;       // Index into Pattern::literals
+    };
+
+    // Aho-Corasick automaton over the literals of one pattern group, as a dense transition table
+    struct Automaton
+    {
+        std::vector<std::array<int32_t, 256>> transitions;
+        std::vector<int32_t> outputLinks;                   // Next node on the fail chain that has outputs, -1 if none
+        std::vector<std::vector<Output>> outputs;           // Literals that end at this node
+    };
+
+    // Patterns matched against the same text: either the file name or the whole relative path
+    struct PatternGroup
+    {
+        std::vector<Pattern> patterns;
+        std::vector<uint32_t> withoutLiteral;               // Patterns without any literal, checked for every name
+        Automaton automaton;
+    };
+
+    static bool Compile(const std::string& source, Pattern& pattern);
+    static bool MatchTokens(const Pattern& pattern, std::string_view text);
+    static bool Verify(const Pattern& pattern, std::string_view text);
+    static void BuildAutomaton(PatternGroup& group);
+
+    template <typename OnMatch>
+    static bool ForEachMatch(const PatternGroup& group, std::string_view text, OnMatch onMatch);
+
+    PatternGroup namePatterns;
+    PatternGroup pathPatterns;
+    size_t patternCount = 0;
+};
@@ -1,5 +1,10 @@
 ﻿#include "Test.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
 #include <stdexcept>
+#include <thread>
 
 void Test::Log(std::string message)
 {
@@ -40,6 +45,7 @@ void Test::LogResult(std::string resultIs, std::string resultexpected, std::stri
 	{
 		Log(testname + ": Result is: " + resultIs + ",  expected result: " + resultexpected + "		FAIL");
 		Log("Stopping tests, " + testname + " was not successfull");
+		failed = true;
 		throw std::runtime_error("Test failed!");
 	}
 
@@ -151,9 +157,15 @@ void Test::TestDiscovery(std::filesystem::path testPath)
 		FileUtils::WriteTextFile(testPath / ("test" + std::to_string(i) + ".txt"), "Test");
 	}
 
+	FileUtils::WriteTextFile(testPath / "data.bin", "Test");
+	FileUtils::WriteTextFile(testPath / "data.txt.bin", "Test");
+	FileUtils::WriteTextFile(testPath / "README", "Test");
+
 	try
 	{
 		Compare(FileUtils::GetFilesByExtension(testPath, ".txt").size(), 10, "GetFilesByExtension");
+		Compare(FileUtils::GetFilesByExtension(testPath, ".bin").size(), 2, "GetFilesByExtensionSkipsOthers");
+		Compare(FileUtils::GetFilesByExtension(testPath, "").size(), 1, "GetFilesByExtensionEmpty");
 		Compare(FileUtils::GetFilesByName(testPath, "test").size(), 10, "GetFilesByExtension");
 		Compare(FileUtils::GetFoldersByName(testPath, "test").size(), 10, "GetFoldersByName");
 	}
@@ -224,20 +236,508 @@ void Test::TestConversions(std::filesystem::path testPath)
 	Log(" ");
 }
 
+void Test::TestBatchOps(std::filesystem::path testPath)
+{
+	testPath /= "TestBatchContainer";
+	std::filesystem::path copyPath = testPath / "Copies";
+	if (!FileUtils::CreateNewFolder(copyPath))
+		Compare(false, true, "SetupTestFolder");
+
+	int count = 50;
+	std::vector<BatchOps::Operation> operations;
+
+	for (int i = 0; i < count; i++)
+	{
+		std::filesystem::path file = testPath / ("batch" + std::to_string(i) + ".txt");
+		std::filesystem::path renamedFile = testPath / ("renamed" + std::to_string(i) + ".txt");
+		FileUtils::WriteTextFile(file, "Test");
+
+		// Each chain depends on the previous operation on the same path, so these only succeed when run in order
+		operations.push_back({ BatchOps::OperationType::RenameFile, file, renamedFile });
+		operations.push_back({ BatchOps::OperationType::CopyFile, renamedFile, copyPath / renamedFile.filename() });
+		operations.push_back({ BatchOps::OperationType::DeleteFile, renamedFile, {} });
+	}
+
+	operations.push_back({ BatchOps::OperationType::MoveFile, testPath / "missing.txt", testPath / "missing2.txt" });
+
+	try
+	{
+		BatchOps batch(4);
+		std::vector<bool> results = batch.Run(operations);
+
+		int succeeded = 0;
+		for (size_t i = 0; i + 1 < results.size(); i++)
+			succeeded += results[i] ? 1 : 0;
+
+		Compare(succeeded, count * 3, "BatchOpsResults");
+		Compare((bool)results.back(), false, "BatchOpsFailedResult");
+		Compare(FileUtils::GetFilesByName(copyPath, "renamed").size(), count, "BatchOpsCopies");
+		Compare(FileUtils::GetFilesByName(testPath, "batch").size(), 0, "BatchOpsRenames");
+		Compare(batch.Run({ { BatchOps::OperationType::DeleteFolder, copyPath, {} } }).front(), true, "BatchOpsDeleteFolder");
+		Compare(FileUtils::FolderExists(copyPath), false, "BatchOpsFolderDeleted");
+	}
+
+	catch (...)
+	{
+		FileUtils::DeleteFolder(testPath);
+		return;
+	}
+
+	FileUtils::DeleteFolder(testPath);
+	Log("All batch operation tests successfull");
+	Log(" ");
+}
+
+void Test::TestMetrics(std::filesystem::path testPath)
+{
+#ifdef FILEUTILS_ENABLE_METRICS
+	testPath /= "TestMetricsContainer";
+	if (!FileUtils::CreateNewFolder(testPath))
+		Compare(false, true, "SetupTestFolder");
+
+	std::filesystem::path filePath = testPath / "metrics.bin";
+	char byteBuffer[5] = { 0,1,2,3,4 };
+	int sinkCalls = 0;
+
+	FileUtilsMetrics::Reset();
+	FileUtilsMetrics::SetSink([&sinkCalls](const FileUtilsMetrics::Record& record)
+	{
+		if (record.operation == FileUtilsMetrics::Operation::WriteBinaryFile)
+			sinkCalls++;
+	});
+
+	try
+	{
+		FileUtils::WriteBinaryFile(filePath, byteBuffer, 5);
+		FileUtils::WriteBinaryFile(testPath / "missing" / "metrics.bin", byteBuffer, 5);
+		FileUtils::GetFilesByName(testPath, "metrics");
+		FileUtilsMetrics::SetSink(nullptr);
+
+		std::filesystem::path treePath = testPath / "tree";
+		FileUtils::CreateNewFolder(treePath / "sub");
+		FileUtils::WriteTextFile(treePath / "sub" / "a.bin", "01234");
+		FileUtils::CopyFile(filePath, treePath / "b.bin");
+		FileUtils::CopyFolder(treePath, testPath / "treeCopy");
+		FileUtils::CopyFolder(treePath, testPath / "treeCopyWithOptions", FileIOOptions());
+
+		FileUtilsMetrics::Snapshot writes = FileUtilsMetrics::GetSnapshot(FileUtilsMetrics::Operation::WriteBinaryFile);
+		Compare((int)writes.calls, 2, "MetricsCalls");
+		Compare((int)writes.failures, 1, "MetricsFailures");
+		Compare((int)writes.bytes, 5, "MetricsBytes");
+		Compare(writes.syscalls > 0, true, "MetricsSyscalls");
+
+		uint64_t histogramCalls = 0;
+		for (uint64_t bucket : writes.latencyHistogram)
+			histogramCalls += bucket;
+		Compare((int)histogramCalls, 2, "MetricsLatencyHistogram");
+
+		Compare((int)FileUtilsMetrics::GetSnapshot(FileUtilsMetrics::Operation::GetFilesByName).entriesScanned, 1, "MetricsEntriesScanned");
+		// The plain copy of the file plus the two files copied by CopyFolder with options
+		Compare((int)FileUtilsMetrics::GetSnapshot(FileUtilsMetrics::Operation::CopyFile).bytes, 15, "MetricsCopyFileBytes");
+
+		FileUtilsMetrics::Snapshot folderCopies = FileUtilsMetrics::GetSnapshot(FileUtilsMetrics::Operation::CopyFolder);
+		Compare((int)folderCopies.bytes, 20, "MetricsCopyFolderBytes");
+		Compare((int)folderCopies.entriesScanned, 6, "MetricsCopyFolderEntries");
+		Compare(FileUtils::FileExists(testPath / "treeCopy" / "sub" / "a.bin"), true, "MetricsCopyFolderContent");
+		Compare(sinkCalls, 2, "MetricsSink");
+	}
+
+	catch (...)
+	{
+		FileUtilsMetrics::SetSink(nullptr);
+		FileUtils::DeleteFolder(testPath);
+		return;
+	}
+
+	FileUtils::DeleteFolder(testPath);
+	Log("All metrics tests successfull");
+#else
+	(void)testPath;
+	Log("Metrics tests skipped, build with FILEUTILS_ENABLE_METRICS to run them");
+#endif
+	Log(" ");
+}
+
+void Test::TestMetadata(std::filesystem::path testPath)
+{
+	testPath /= "TestMetadataContainer";
+	if (!FileUtils::CreateNewFolder(testPath / "folder"))
+		Compare(false, true, "SetupTestFolder");
+
+	// More files than one chunk, so the parallel path gets used as well
+	int count = 1500;
+	std::vector<std::filesystem::path> paths;
+
+	for (int i = 0; i < count; i++)
+	{
+		std::filesystem::path file = testPath / ("file" + std::to_string(i) + ".txt");
+		FileUtils::WriteTextFile(file, std::string(i % 100, 'x'));
+		paths.push_back(file);
+	}
+
+	paths.push_back(testPath / "missing.txt");
+	paths.push_back(testPath / "folder");
+
+	try
+	{
+		FileMetadata metadata = FileUtils::GetMetadata(paths);
+
+		bool sizesMatch = true;
+		for (int i = 0; i < count; i++)
+			sizesMatch = sizesMatch && metadata.sizes[i] == (uint64_t)(i % 100) && metadata.types[i] == FileMetadata::Type::File;
+
+		Compare(sizesMatch, true, "GetMetadataSizes");
+		Compare(metadata.modificationTimes[0] > 0, true, "GetMetadataModificationTime");
+		Compare(metadata.types[count] == FileMetadata::Type::NotFound, true, "GetMetadataNotFound");
+		Compare(metadata.types[count + 1] == FileMetadata::Type::Folder, true, "GetMetadataFolder");
+
+		FileMetadata sizesOnly = FileUtils::GetMetadata(paths, FileMetadata::Size);
+		Compare(sizesOnly.sizes.size() == paths.size() && sizesOnly.modificationTimes.empty() && sizesOnly.inodes.empty(), true, "GetMetadataFields");
+
+		Compare((int)FileUtils::GetFolderMetadata(testPath).paths.size(), count + 1, "GetFolderMetadata");
+		Compare((int)FileUtils::GetFolderMetadata(testPath / "missing").paths.size(), 0, "GetFolderMetadataMissing");
+	}
+
+	catch (...)
+	{
+		FileUtils::DeleteFolder(testPath);
+		return;
+	}
+
+	FileUtils::DeleteFolder(testPath);
+	Log("All metadata tests successfull");
+	Log(" ");
+}
+
+void Test::TestTreeStats(std::filesystem::path testPath)
+{
+	testPath /= "TestTreeStatsContainer";
+	std::filesystem::path childPath = testPath / "child";
+	std::filesystem::path grandChildPath = childPath / "grandChild";
+	if (!FileUtils::CreateNewFolder(grandChildPath))
+		Compare(false, true, "SetupTestFolder");
+
+	FileUtils::WriteTextFile(testPath / "root.txt", "1234");
+	FileUtils::WriteTextFile(childPath / "child.txt", "12");
+	FileUtils::WriteTextFile(childPath / "child.bin", "123456");
+	FileUtils::WriteTextFile(grandChildPath / "grandChild.txt", "1");
+
+	// A second hard link to the same file must not be counted twice
+	std::error_code error;
+	std::filesystem::create_hard_link(grandChildPath / "grandChild.txt", childPath / "link.txt", error);
+
+	try
+	{
+		TreeStats stats = FileUtils::ScanTreeStats(testPath);
+		Compare((int)stats.folders.size(), 3, "ScanTreeStatsFolders");
+		Compare(stats.folders[0].path, testPath, "ScanTreeStatsRootFirst");
+		Compare((int)stats.folders[0].size, 13, "ScanTreeStatsSize");
+		Compare((int)stats.folders[0].fileCount, 4, "ScanTreeStatsFileCount");
+		Compare((int)stats.folders[0].folderCount, 2, "ScanTreeStatsFolderCount");
+		Compare((int)stats.folders[0].extensions[".txt"].fileCount, 3, "ScanTreeStatsExtensions");
+		Compare((int)stats.folders[0].ageHistogram[0], 4, "ScanTreeStatsAgeHistogram");
+		Compare((int)stats.folders[1].size, 9, "ScanTreeStatsChildSize");
+
+		TreeStats limited = FileUtils::ScanTreeStats(testPath, 1);
+		Compare((int)limited.folders.size(), 2, "ScanTreeStatsDepthLimit");
+		Compare((int)limited.folders[1].fileCount, 3, "ScanTreeStatsDepthLimitCounts");
+
+		Compare((int)FileUtils::ScanTreeStats(testPath / "missing").folders.size(), 0, "ScanTreeStatsMissing");
+	}
+
+	catch (...)
+	{
+		FileUtils::DeleteFolder(testPath);
+		return;
+	}
+
+	FileUtils::DeleteFolder(testPath);
+	Log("All tree statistics tests successfull");
+	Log(" ");
+}
+
+void Test::TestPatterns(std::filesystem::path testPath)
+{
+	testPath /= "TestPatternContainer";
+	std::filesystem::path shotPath = testPath / "shot_v01";
+	std::filesystem::path renderPath = shotPath / "renders" / "beauty";
+	std::filesystem::path nearMissPath = testPath / "renders" / "a";
+	if (!FileUtils::CreateNewFolder(renderPath) || !FileUtils::CreateNewFolder(nearMissPath))
+		Compare(false, true, "SetupTestFolder");
+
+	FileUtils::WriteTextFile(testPath / "plate_v01.exr", "1");
+	FileUtils::WriteTextFile(testPath / "plate_v1.exr", "1");
+	FileUtils::WriteTextFile(testPath / "notes.txt", "1");
+	FileUtils::WriteTextFile(shotPath / "comp_v12.exr", "1");
+	FileUtils::WriteTextFile(renderPath / "beauty_v03.exr", "1");
+	FileUtils::WriteTextFile(testPath / "renders" / "beauty.exr", "1");
+	FileUtils::WriteTextFile(testPath / "renders" / "old_beauty.exr", "1");
+	FileUtils::WriteTextFile(nearMissPath / "beauty.exr", "1");
+	FileUtils::WriteTextFile(nearMissPath / "xbeauty.exr", "1");
+
+	try
+	{
+		PathMatcher version({ "*_v[0-9][0-9].exr" });
+		Compare(version.Matches("plate_v01.exr"), true, "PatternCharClass");
+		Compare(version.Matches("plate_v1.exr"), false, "PatternCharClassCount");
+		Compare(version.Matches("folder/plate_v01.exr"), true, "PatternMatchesFilenameOnly");
+
+		PathMatcher globs({ "a?c", "[!x]*.txt", "renders/**/*.exr", "*.t\\*t" });
+		Compare(globs.Matches("abc"), true, "PatternAnyChar");
+		Compare(globs.Matches("xfile.txt"), false, "PatternNegatedClass");
+		Compare(globs.Matches("renders/beauty.exr"), true, "PatternGlobStarEmpty");
+		Compare(globs.Matches("renders/a/b/beauty.exr"), true, "PatternGlobStar");
+		Compare(globs.Matches("shot/renders/beauty.exr"), false, "PatternPathAnchored");
+		Compare(globs.Matches("file.t*t"), true, "PatternEscape");
+
+		// After matching anything "**/" has to end at a '/'
+		PathMatcher globStarSlash({ "a/**/b", "**/b.exr" });
+		Compare(globStarSlash.Matches("a/b"), true, "PatternGlobStarSlashEmpty");
+		Compare(globStarSlash.Matches("a/x/y/b"), true, "PatternGlobStarSlashFolders");
+		Compare(globStarSlash.Matches("a/xb"), false, "PatternGlobStarSlashPartialName");
+		Compare(globStarSlash.Matches("a/x/yb"), false, "PatternGlobStarSlashPartialNameInFolder");
+		Compare(globStarSlash.Matches("x/b.exr"), true, "PatternLeadingGlobStarSlash");
+		Compare(globStarSlash.Matches("xb.exr"), false, "PatternLeadingGlobStarSlashPartialName");
+
+		// Many patterns in one pass, every match is reported once even if its literal occurs several times
+		std::vector<std::string> many;
+		for (int i = 0; i < 300; i++)
+			many.push_back("*frame" + std::to_string(i) + "*");
+		many.push_back("*.exr");
+		PathMatcher manyMatcher(many);
+		std::vector<size_t> matches;
+		manyMatcher.GetMatches("frame12_frame12.exr", matches);
+		Compare((int)manyMatcher.GetPatternCount(), 301, "PatternCount");
+		Compare((int)matches.size(), 3, "PatternMultiMatchCount");
+		Compare(matches.size() == 3 && matches[0] == 1 && matches[1] == 12 && matches[2] == 300, true, "PatternMultiMatchIndices");
+
+		Compare((int)FileUtils::GetFilesByPattern(testPath, version).size(), 1, "GetFilesByPattern");
+		Compare((int)FileUtils::GetFilesByPattern(testPath, version, true).size(), 3, "GetFilesByPatternRecursive");
+		Compare((int)FileUtils::GetFilesByPattern(testPath, PathMatcher({ "shot_*/**/*.exr" }), true).size(), 2, "GetFilesByPatternPath");
+		Compare((int)FileUtils::GetFilesByPattern(testPath, PathMatcher({ "renders/**/beauty.exr" }), true).size(), 2, "GetFilesByPatternGlobStarSlash");
+		Compare((int)FileUtils::GetFoldersByPattern(testPath, PathMatcher({ "shot_v[0-9]*", "beauty" }), true).size(), 2, "GetFoldersByPattern");
+
+		// Only the file name counts, not the name of the searched folder
+		Compare((int)FileUtils::GetFilesByName(shotPath, "shot").size(), 0, "GetFilesByNameIgnoresFolder");
+	}
+
+	catch (...)
+	{
+		FileUtils::DeleteFolder(testPath);
+		return;
+	}
+
+	FileUtils::DeleteFolder(testPath);
+	Log("All pattern matching tests successfull");
+	Log(" ");
+}
+
+void Test::TestSparseFiles(std::filesystem::path testPath)
+{
+	testPath /= "TestSparseContainer";
+	std::filesystem::path sparsePath = testPath / "sparse.bin";
+	std::filesystem::path copyPath = testPath / "copy.bin";
+	if (!FileUtils::CreateNewFolder(testPath))
+		Compare(false, true, "SetupTestFolder");
+
+	// 4 MB of zeros with a bit of data at the start, in the middle and an unaligned tail at the end
+	std::vector<char> bytes(4 * 1024 * 1024 + 100, 0);
+	std::fill(bytes.begin(), bytes.begin() + 10, 'a');
+	std::fill(bytes.begin() + 2 * 1024 * 1024, bytes.begin() + 2 * 1024 * 1024 + 5000, 'b');
+	bytes.back() = 'c';
+
+	FileIOOptions options;
+	options.sparse = true;
+	options.preallocate = true;
+
+	try
+	{
+		Compare(FileUtils::WriteBinaryFile(sparsePath, bytes.data(), bytes.size(), options), true, "WriteBinaryFileSparse");
+
+		size_t size = 0;
+		char* read = FileUtils::ReadBinaryFile(sparsePath, options, &size);
+		Compare(read != nullptr && size == bytes.size() && std::equal(bytes.begin(), bytes.end(), read), true, "ReadBinaryFileSparse");
+		delete[] read;
+
+		Compare(FileUtils::CopyFile(sparsePath, copyPath, options), true, "CopyFileSparse");
+		Compare(FileUtils::CopyFile(sparsePath, copyPath, options), false, "CopyFileSparseExisting");
+		read = FileUtils::ReadBinaryFile(copyPath, FileIOOptions(), &size);
+		Compare(read != nullptr && size == bytes.size() && std::equal(bytes.begin(), bytes.end(), read), true, "CopyFileSparseContent");
+		delete[] read;
+
+		Compare(FileUtils::CopyFolder(testPath, testPath.parent_path() / "TestSparseCopy", options), true, "CopyFolderWithOptions");
+		Compare(FileUtils::FileExists(testPath.parent_path() / "TestSparseCopy" / "copy.bin"), true, "CopyFolderWithOptionsContent");
+		FileUtils::DeleteFolder(testPath.parent_path() / "TestSparseCopy");
+
+		// Default options copy like the plain overload: the parent of the destination has to exist,
+		// folders keep their permissions and entries that can't be copied fail the copy
+		std::filesystem::path folderCopyPath = testPath.parent_path() / "TestSparseCopy";
+		Compare(FileUtils::CopyFolder(testPath, testPath.parent_path() / "missing" / "TestSparseCopy", FileIOOptions()), false, "CopyFolderWithOptionsMissingParent");
+#ifndef _WIN32
+		std::filesystem::path privatePath = testPath / "private";
+		std::filesystem::create_directory(privatePath);
+		std::filesystem::permissions(privatePath, std::filesystem::perms::owner_all);
+		Compare(FileUtils::CopyFolder(testPath, folderCopyPath, FileIOOptions()), true, "CopyFolderWithOptionsDefault");
+		Compare(std::filesystem::status(folderCopyPath / "private").permissions() == std::filesystem::perms::owner_all, true, "CopyFolderWithOptionsPermissions");
+		FileUtils::DeleteFolder(folderCopyPath);
+
+		std::filesystem::create_symlink(testPath / "missing.bin", privatePath / "broken.bin");
+		Compare(FileUtils::CopyFolder(testPath, folderCopyPath), false, "CopyFolderBrokenLink");
+		FileUtils::DeleteFolder(folderCopyPath);
+		Compare(FileUtils::CopyFolder(testPath, folderCopyPath, FileIOOptions()), false, "CopyFolderWithOptionsBrokenLink");
+		FileUtils::DeleteFolder(folderCopyPath);
+		FileUtils::DeleteFolder(privatePath);
+#endif
+
+#ifdef __linux__
+		// Only the blocks with data take up disk space, in the written file and in the copy
+		TreeStats stats = FileUtils::ScanTreeStats(testPath);
+		Compare(stats.folders.size() == 1 && stats.folders[0].diskUsage < bytes.size(), true, "SparseDiskUsage");
+#endif
+	}
+
+	catch (...)
+	{
+		FileUtils::DeleteFolder(testPath);
+		return;
+	}
+
+	FileUtils::DeleteFolder(testPath);
+	Log("All sparse file tests successfull");
+	Log(" ");
+}
+
+void Test::TestDirectIO(std::filesystem::path testPath)
+{
+	testPath /= "TestDirectIOContainer";
+	std::filesystem::path filePath = testPath / "direct.bin";
+	std::filesystem::path copyPath = testPath / "copy.bin";
+	if (!FileUtils::CreateNewFolder(testPath))
+		Compare(false, true, "SetupTestFolder");
+
+	// Larger than one pool buffer and not a multiple of the alignment, so there is an unaligned tail
+	std::vector<char> bytes(AlignedBufferPool::DefaultBufferSize * 2 + 1234);
+	for (size_t i = 0; i < bytes.size(); i++)
+		bytes[i] = (char)(i * 31 + i / 4096);
+
+	FileIOOptions options;
+	options.directIO = true;
+
+	try
+	{
+		// Start one byte into the vector, so the caller memory is not aligned either
+		Compare(FileUtils::WriteBinaryFile(filePath, bytes.data() + 1, bytes.size() - 1, options), true, "WriteBinaryFileDirect");
+		Compare((int)std::filesystem::file_size(filePath), (int)bytes.size() - 1, "WriteBinaryFileDirectSize");
+
+		size_t size = 0;
+		char* read = FileUtils::ReadBinaryFile(filePath, options, &size);
+		Compare(read != nullptr && size == bytes.size() - 1 && std::equal(bytes.begin() + 1, bytes.end(), read), true, "ReadBinaryFileDirect");
+		delete[] read;
+
+		Compare(FileUtils::CopyFile(filePath, copyPath, options), true, "CopyFileDirect");
+		read = FileUtils::ReadBinaryFile(copyPath, FileIOOptions(), &size);
+		Compare(read != nullptr && size == bytes.size() - 1 && std::equal(bytes.begin() + 1, bytes.end(), read), true, "CopyFileDirectContent");
+		delete[] read;
+
+		// Direct IO together with holes, data in the middle of a hole is not block aligned
+		std::vector<char> sparseBytes(3 * 1024 * 1024 + 77, 0);
+		std::fill(sparseBytes.begin() + 1000000, sparseBytes.begin() + 1000100, 'x');
+		options.sparse = true;
+		FileUtils::DeleteFile(copyPath);
+		Compare(FileUtils::WriteBinaryFile(filePath, sparseBytes.data(), sparseBytes.size(), options), true, "WriteBinaryFileDirectSparse");
+		Compare(FileUtils::CopyFile(filePath, copyPath, options), true, "CopyFileDirectSparse");
+		read = FileUtils::ReadBinaryFile(copyPath, options, &size);
+		Compare(read != nullptr && size == sparseBytes.size() && std::equal(sparseBytes.begin(), sparseBytes.end(), read), true, "ReadBinaryFileDirectSparse");
+		delete[] read;
+
+		read = FileUtils::ReadBinaryFile(testPath / "missing.bin", options, &size);
+		Compare(read == nullptr && size == 0, true, "ReadBinaryFileDirectMissing");
+
+		// A file that grows while it is read: the result is the file as large as it was when the read started, the data
+		// appended meanwhile must not be written past the end of the returned buffer. The race needs many rounds to hit.
+		std::vector<char> start(100, 'a');
+		std::string appended(3000, 'b');
+		options.sparse = false;
+		bool allRead = true;
+
+		for (int round = 0; round < 3000 && allRead; round++)
+		{
+			FileUtils::WriteBinaryFile(filePath, start.data(), start.size());
+
+			std::atomic<bool> growing{ true };
+			std::thread appender([&filePath, &appended, &growing]()
+			{
+				std::ofstream file(filePath, std::ios::binary | std::ios::app);
+				file.write(appended.data(), appended.size());
+				file.close();
+				growing = false;
+			});
+
+			do
+			{
+				read = FileUtils::ReadBinaryFile(filePath, options, &size);
+				allRead = allRead && read != nullptr && size >= start.size() && std::equal(start.begin(), start.end(), read);
+				delete[] read;
+			} while (growing);
+
+			appender.join();
+		}
+
+		Compare(allRead, true, "ReadBinaryFileDirectGrowing");
+
+		// Buffers go back to the pool and are reused
+		AlignedBufferPool pool(1000, 1);
+		{
+			AlignedBufferPool::Buffer first = pool.Acquire();
+			AlignedBufferPool::Buffer second = pool.Acquire();
+			Compare((int)first.GetSize(), (int)AlignedBufferPool::Alignment, "AlignedBufferSize");
+			Compare((uintptr_t)first.GetData() % AlignedBufferPool::Alignment == 0, true, "AlignedBufferAlignment");
+		}
+		Compare((int)pool.GetIdleBufferCount(), 1, "AlignedBufferPoolIdle");
+	}
+
+	catch (...)
+	{
+		FileUtils::DeleteFolder(testPath);
+		return;
+	}
+
+	FileUtils::DeleteFolder(testPath);
+	Log("All direct IO tests successfull");
+	Log(" ");
+}
+
 int Test::RunAllTests(std::filesystem::path testPath)
 {
 	TestFolderBasics(testPath);
 	TestFileBasics(testPath);
 	TestDiscovery(testPath);
 	TestConversions(testPath);
+	TestBatchOps(testPath);
+	TestMetrics(testPath);
+	TestMetadata(testPath);
+	TestTreeStats(testPath);
+	TestPatterns(testPath);
+	TestSparseFiles(testPath);
+	TestDirectIO(testPath);
 	Log("\r \r ");
+
+	if (failed)
+	{
+		Log("Tests failed");
+		return 1;
+	}
+
 	Log("All tests successfull");
 	return 0;
 }
 
 
-int main()
+int main(int argc, char* argv[])
 {
+	// The tests create and remove their own sub folders below this path
+	std::filesystem::path testPath = argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::temp_directory_path() / "FileUtilTest";
+
 	Test test;
-	test.RunAllTests("C:\\FileUtilTest\\");
+	return test.RunAllTests(testPath);
 }
@@ -1,10 +1,20 @@
 #pragma once
-#include "FileUtils.h";
+#include "FileUtils.h"
+#include "AlignedBufferPool.h"
+#include "BatchOps.h"
+#include "PathMatcher.h"
+#include "TreeStats.h"
+
+#ifdef FILEUTILS_ENABLE_METRICS
+#include "FileUtilsMetrics.h"
+#endif
 
 
 class Test
 {
 private:
+	bool failed = false;
+
 	void Log(std::string message);
 	void Compare(bool actual, bool should, std::string testname);
 	void Compare(int actual, int should, std::string testname);
@@ -16,6 +26,13 @@ private:
 	void TestFileBasics(std::filesystem::path testPath);
 	void TestDiscovery(std::filesystem::path testPath);
 	void TestConversions(std::filesystem::path testPath);
+	void TestBatchOps(std::filesystem::path testPath);
+	void TestMetrics(std::filesystem::path testPath);
+	void TestMetadata(std::filesystem::path testPath);
+	void TestTreeStats(std::filesystem::path testPath);
+	void TestPatterns(std::filesystem::path testPath);
+	void TestSparseFiles(std::filesystem::path testPath);
+	void TestDirectIO(std::filesystem::path testPath);
 
 public:
 	int RunAllTests(std::filesystem::path);
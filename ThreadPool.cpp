@@ -0,0 +1,222 @@
+#include "ThreadPool.h"
+#include <chrono>
+
+
+// The pool and queue index of the worker running on the current thread, null on threads that are not pool workers
+thread_local ThreadPool* ThreadPool::currentPool = nullptr;
+thread_local size_t ThreadPool::currentWorker = 0;
+
+/// <summary>
+/// Starts the worker threads
+/// </summary>
+/// <param name="threadCount">The number of worker threads, 0 uses the number of hardware threads</param>
+ThreadPool::ThreadPool(unsigned int threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::thread::hardware_concurrency();
+
+    if (threadCount == 0)
+        threadCount = 1;
+
+    for (unsigned int i = 0; i < threadCount; i++)
+        queues.push_back(std::make_unique<WorkerQueue>());
+
+    for (unsigned int i = 0; i < threadCount; i++)
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+/// <summary>
+/// Runs all remaining tasks and joins the worker threads
+/// </summary>
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+
+    wakeCondition.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+/// <summary>
+/// Get the process wide pool used by the parallel FileUtils functions. It is created on first use with one worker per hardware thread.
+/// </summary>
+/// <returns>The shared pool</returns>
+ThreadPool& ThreadPool::GetShared()
+{
+    static ThreadPool shared;
+    return shared;
+}
+
+/// <summary>
+/// Queues a task for execution on one of the worker threads. Exceptions thrown by the task are swallowed.
+/// </summary>
+/// <param name="task">The task to run</param>
+void ThreadPool::Submit(std::function<void()> task)
+{
+    size_t queueIndex = currentPool == this ? currentWorker : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    // Counted before it is published, otherwise a worker could pop the task and decrement the counter below zero.
+    // Taking the wake mutex orders the increment against a worker that is just about to go to sleep.
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        pendingTasks.fetch_add(1, std::memory_order_release);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queues[queueIndex]->mutex);
+        queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+
+    wakeCondition.notify_one();
+}
+
+/// <summary>
+/// Runs one pending task on the calling thread, if there is any
+/// </summary>
+/// <returns>True if a task has been run, false if all queues were empty</returns>
+bool ThreadPool::TryRunPendingTask()
+{
+    std::function<void()> task;
+    size_t preferredQueue = currentPool == this ? currentWorker : 0;
+
+    if (!TryPopTask(preferredQueue, task))
+        return false;
+
+    try
+    {
+        task();
+    }
+
+    catch (...)
+    {
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Get the number of worker threads
+/// </summary>
+/// <returns>The number of worker threads of this pool</returns>
+unsigned int ThreadPool::GetThreadCount() const
+{
+    return static_cast<unsigned int>(workers.size());
+}
+
+void ThreadPool::WorkerLoop(size_t index)
+{
+    currentPool = this;
+    currentWorker = index;
+
+    while (true)
+    {
+        if (TryRunPendingTask())
+            continue;
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wakeCondition.wait(lock, [this] { return stopping || pendingTasks.load(std::memory_order_acquire) > 0; });
+
+        if (stopping && pendingTasks.load(std::memory_order_acquire) == 0)
+            return;
+    }
+}
+
+bool ThreadPool::TryPopTask(size_t preferredQueue, std::function<void()>& task)
+{
+    if (pendingTasks.load(std::memory_order_acquire) == 0)
+        return false;
+
+    // Own queue first, newest task first, that keeps recursive work cache friendly
+    {
+        WorkerQueue& own = *queues[preferredQueue];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    // Steal the oldest task of another queue
+    for (size_t i = 1; i < queues.size(); i++)
+    {
+        WorkerQueue& victim = *queues[(preferredQueue + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+ThreadPool::TaskGroup::TaskGroup(ThreadPool& pool) : pool(pool)
+{
+}
+
+/// <summary>
+/// Waits for all tasks of the group, a group must never be destroyed while its tasks are still running
+/// </summary>
+ThreadPool::TaskGroup::~TaskGroup()
+{
+    Wait();
+}
+
+/// <summary>
+/// Submits a task to the pool as part of this group
+/// </summary>
+/// <param name="task">The task to run</param>
+void ThreadPool::TaskGroup::Run(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running++;
+    }
+
+    pool.Submit([this, task = std::move(task)]()
+    {
+        struct Done
+        {
+            TaskGroup* group;
+            ~Done()
+            {
+                std::lock_guard<std::mutex> lock(group->mutex);
+                if (--group->running == 0)
+                    group->finished.notify_all();
+            }
+        } done{ this };
+
+        task();
+    });
+}
+
+/// <summary>
+/// Blocks until all tasks of this group have finished. The calling thread runs pending pool tasks in the meantime.
+/// </summary>
+void ThreadPool::TaskGroup::Wait()
+{
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (running == 0)
+                return;
+        }
+
+        if (pool.TryRunPendingTask())
+            continue;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait_for(lock, std::chrono::milliseconds(1), [this] { return running == 0; });
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// A small work-stealing thread pool used by the batch and parallel helpers of this library.
+// Every worker owns a task queue. Workers take tasks from the back of their own queue and steal from the front of the other queues when they run dry.
+// Tasks submitted from inside a worker land on that worker's own queue, so recursive work stays local until another worker steals it.
+//
+// Thread safety: all public functions may be called concurrently from any thread, including from inside a running task.
+
+class ThreadPool
+{
+public:
+    class TaskGroup;
+
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    static ThreadPool& GetShared();
+
+    void Submit(std::function<void()> task);
+    bool TryRunPendingTask();
+    unsigned int GetThreadCount() const;
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void WorkerLoop(size_t index);
+    bool TryPopTask(size_t preferredQueue, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<size_t> pendingTasks{ 0 };
+    std::atomic<size_t> nextQueue{ 0 };
+    bool stopping = false;
+
+    static thread_local ThreadPool* currentPool;
+    static thread_local size_t currentWorker;
+};
+
+
+// Tracks a set of tasks submitted to a ThreadPool so the caller can wait until all of them have finished.
+// While waiting, the calling thread helps out by running pending tasks of the pool, so waiting from inside a task can not deadlock the pool.
+class ThreadPool::TaskGroup
+{
+public:
+    explicit TaskGroup(ThreadPool& pool);
+    ~TaskGroup();
+
+    void Run(std::function<void()> task);
+    void Wait();
+
+private:
+    ThreadPool& pool;
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t running = 0;
+};
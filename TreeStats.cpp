@@ -0,0 +1,312 @@
+#include "TreeStats.h"
+#include "FileUtilsInternal.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+#ifdef FILEUTILS_POSIX
+#include <dirent.h>
+#include <fcntl.h>
+#endif
+
+
+namespace
+{
+    // A folder that gets its own entry in the result. Folders deeper than the depth limit have no node,
+    // their content is merged straight into the node of their ancestor at the depth limit.
+    struct TreeStatsNode
+    {
+        TreeStats::FolderStats stats;   // Content of this folder only, until the sub-folders are rolled up after the scan
+        TreeStatsNode* parent = nullptr;
+        std::mutex mutex;               // Guards stats while the scans of deeper folders merge into it
+        std::vector<std::unique_ptr<TreeStatsNode>> children;  // Only touched by the task scanning this folder
+    };
+
+    // State shared by all tasks of one scan
+    struct TreeStatsScan
+    {
+        ThreadPool::TaskGroup* group;
+        int maxDepth;
+        int64_t startTimeNs;
+        std::atomic<uint64_t> unreadableFolders{ 0 };
+
+        // (device, inode) of files with more than one hard link, sharded to keep lock contention low
+        struct FileId
+        {
+            uint64_t device;
+            uint64_t inode;
+
+            bool operator==(const FileId& other) const { return device == other.device && inode == other.inode; }
+        };
+        struct FileIdHash
+        {
+            size_t operator()(const FileId& id) const { return (size_t)Mix(id.device, id.inode); }
+        };
+
+        static const size_t ShardCount = 64;
+        struct HardLinkShard
+        {
+            std::mutex mutex;
+            std::unordered_set<FileId, FileIdHash> seen;
+        };
+        std::array<HardLinkShard, ShardCount> hardLinks;
+
+        static uint64_t Mix(uint64_t device, uint64_t inode)
+        {
+            return inode * 0x9E3779B97F4A7C15ull ^ device;
+        }
+
+        bool IsFirstHardLink(uint64_t device, uint64_t inode)
+        {
+            // The mixed value only picks the shard, the set keeps the whole pair so different files never collide
+            HardLinkShard& shard = hardLinks[(Mix(device, inode) >> 58) % ShardCount];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            return shard.seen.insert({ device, inode }).second;
+        }
+    };
+}
+
+
+static size_t GetAgeBucket(int64_t ageNs)
+{
+    static const int64_t day = 24LL * 60 * 60 * 1000000000;
+    static const int64_t limits[TreeStats::AgeBucketCount - 1] = { day, 7 * day, 30 * day, 365 * day };
+
+    for (size_t i = 0; i < TreeStats::AgeBucketCount - 1; i++)
+    {
+        if (ageNs < limits[i])
+            return i;
+    }
+
+    return TreeStats::AgeBucketCount - 1;
+}
+
+static void AddFile(TreeStats::FolderStats& stats, const TreeStatsScan& scan, const std::string& extension, uint64_t size, uint64_t diskUsage, int64_t modificationTimeNs)
+{
+    stats.size += size;
+    stats.diskUsage += diskUsage;
+    stats.fileCount++;
+    stats.ageHistogram[GetAgeBucket(scan.startTimeNs - modificationTimeNs)]++;
+
+    TreeStats::ExtensionStats& extensionStats = stats.extensions[extension];
+    extensionStats.fileCount++;
+    extensionStats.size += size;
+}
+
+static void MergeStats(TreeStats::FolderStats& target, const TreeStats::FolderStats& source)
+{
+    target.size += source.size;
+    target.diskUsage += source.diskUsage;
+    target.fileCount += source.fileCount;
+    target.folderCount += source.folderCount;
+
+    for (size_t i = 0; i < TreeStats::AgeBucketCount; i++)
+        target.ageHistogram[i] += source.ageHistogram[i];
+
+    for (auto& extension : source.extensions)
+    {
+        TreeStats::ExtensionStats& extensionStats = target.extensions[extension.first];
+        extensionStats.fileCount += extension.second.fileCount;
+        extensionStats.size += extension.second.size;
+    }
+}
+
+static std::string GetExtension(std::string_view name)
+{
+    size_t dot = FindExtension(name);
+    return dot == std::string_view::npos ? std::string() : std::string(name.substr(dot));
+}
+
+/// <summary>
+/// Scans one folder. Files are added to the node of the folder (or of its ancestor at the depth limit), a task is started for every sub-folder.
+/// </summary>
+static void ScanFolder(TreeStatsScan& scan, std::filesystem::path path, int depth, TreeStatsNode* target)
+{
+    TreeStats::FolderStats local;
+    std::vector<std::pair<std::filesystem::path, TreeStatsNode*>> subFolders;
+    bool ownNode = scan.maxDepth < 0 || depth < scan.maxDepth;
+
+    auto addSubFolder = [&](std::filesystem::path subFolder)
+    {
+        local.folderCount++;
+
+        if (!ownNode)
+        {
+            subFolders.emplace_back(std::move(subFolder), target);
+            return;
+        }
+
+        auto child = std::make_unique<TreeStatsNode>();
+        child->stats.path = subFolder;
+        child->stats.depth = depth + 1;
+        child->parent = target;
+        subFolders.emplace_back(std::move(subFolder), child.get());
+        target->children.push_back(std::move(child));
+    };
+
+#ifdef FILEUTILS_POSIX
+    DIR* directory = opendir(path.c_str());
+    if (!directory)
+    {
+        scan.unreadableFolders++;
+        return;
+    }
+
+    int directoryFd = dirfd(directory);
+    while (dirent* entry = readdir(directory))
+    {
+        const char* name = entry->d_name;
+        if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0)))
+            continue;
+
+        // d_type saves the stat call for sub-folders, not every file system fills it in
+        if (entry->d_type == DT_DIR)
+        {
+            addSubFolder(path / name);
+            continue;
+        }
+
+        if (entry->d_type != DT_REG && entry->d_type != DT_UNKNOWN)
+            continue;
+
+        struct stat info;
+        if (fstatat(directoryFd, name, &info, AT_SYMLINK_NOFOLLOW) != 0)
+            continue;
+
+        if (S_ISDIR(info.st_mode))
+        {
+            addSubFolder(path / name);
+            continue;
+        }
+
+        if (!S_ISREG(info.st_mode))
+            continue;
+
+        if (info.st_nlink > 1 && !scan.IsFirstHardLink((uint64_t)info.st_dev, (uint64_t)info.st_ino))
+            continue;
+
+        AddFile(local, scan, GetExtension(name), (uint64_t)info.st_size, (uint64_t)info.st_blocks * 512, GetModificationTimeNs(info));
+    }
+
+    closedir(directory);
+#else
+    std::error_code error;
+    std::filesystem::directory_iterator iterator(path, error);
+    if (error)
+    {
+        scan.unreadableFolders++;
+        return;
+    }
+
+    for (std::filesystem::directory_iterator end; iterator != end; iterator.increment(error))
+    {
+        if (error)
+            break;
+
+        const std::filesystem::directory_entry& entry = *iterator;
+        std::filesystem::file_status status = entry.symlink_status(error);
+        if (error)
+            continue;
+
+        if (std::filesystem::is_directory(status))
+        {
+            addSubFolder(entry.path());
+            continue;
+        }
+
+        if (!std::filesystem::is_regular_file(status))
+            continue;
+
+        uint64_t size = entry.file_size(error);
+        if (error)
+            continue;
+
+        std::filesystem::file_time_type fileTime = entry.last_write_time(error);
+        int64_t modificationTimeNs = error ? scan.startTimeNs : FileTimeToUnixNs(fileTime);
+
+        AddFile(local, scan, GetExtension(GetFilenameView(entry.path())), size, size, modificationTimeNs);
+    }
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(target->mutex);
+        MergeStats(target->stats, local);
+    }
+
+    for (auto& subFolder : subFolders)
+    {
+        TreeStatsNode* subTarget = subFolder.second;
+        scan.group->Run([&scan, subPath = std::move(subFolder.first), depth, subTarget]()
+        {
+            ScanFolder(scan, subPath, depth + 1, subTarget);
+        });
+    }
+}
+
+
+/// <summary>
+/// Get disk usage, file counts and extension/age histograms for a folder and all of its sub-folders.
+/// The folders are scanned in parallel on the shared thread pool, see TreeStats.h for what is counted.
+/// </summary>
+/// <param name="path">The folder to scan</param>
+/// <param name="maxDepth">The deepest level of sub-folders that get their own entry, 0 returns only the scanned folder. Deeper folders are still scanned
+/// and counted in their ancestors, like du --max-depth. A negative value returns every folder.</param>
+/// <returns>The statistics per folder. Empty if the folder does not exist</returns>
+TreeStats FileUtils::ScanTreeStats(std::filesystem::path path, int maxDepth)
+{
+    FILEUTILS_METRICS_SCOPE(ScanTreeStats);
+    TreeStats result;
+
+    if (!FolderExists(path))
+    {
+        FILEUTILS_METRICS_FAIL();
+        return result;
+    }
+
+    TreeStatsNode root;
+    root.stats.path = path;
+
+    {
+        ThreadPool::TaskGroup group(ThreadPool::GetShared());
+        TreeStatsScan scan;
+        scan.group = &group;
+        scan.maxDepth = maxDepth;
+        scan.startTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+        group.Run([&scan, &path, &root]()
+        {
+            ScanFolder(scan, path, 0, &root);
+        });
+
+        group.Wait();
+        result.unreadableFolders = scan.unreadableFolders;
+    }
+
+    // Pre-order walk to collect the nodes, parents before children, then roll the totals up in reverse order
+    std::vector<TreeStatsNode*> order;
+    std::vector<TreeStatsNode*> pending = { &root };
+
+    while (!pending.empty())
+    {
+        TreeStatsNode* node = pending.back();
+        pending.pop_back();
+        order.push_back(node);
+
+        for (auto& child : node->children)
+            pending.push_back(child.get());
+    }
+
+    for (size_t i = order.size(); i-- > 1;)
+        MergeStats(order[i]->parent->stats, order[i]->stats);
+
+    FILEUTILS_METRICS_ENTRIES(root.stats.fileCount + root.stats.folderCount);
+
+    result.folders.reserve(order.size());
+    for (TreeStatsNode* node : order)
+        result.folders.push_back(std::move(node->stats));
+
+    return result;
+}
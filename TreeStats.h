@@ -0,0 +1,39 @@
+#pragma once
+#include "FileUtils.h"
+#include <array>
+#include <unordered_map>
+
+
+// Result of FileUtils::ScanTreeStats. Disk usage, file counts and extension/age histograms of a folder tree,
+// aggregated per folder: the numbers of a folder always include everything below it, like du does.
+//
+// Only regular files are counted. Links are not followed. A file with several hard links is counted once,
+// at whichever of its paths the scan reaches first (Windows: counted at every path).
+
+struct TreeStats
+{
+    // Age buckets by modification time, relative to the start of the scan:
+    // younger than a day, a week, 30 days, 365 days, older. Files from the future land in the first bucket.
+    static constexpr size_t AgeBucketCount = 5;
+
+    struct ExtensionStats
+    {
+        uint64_t fileCount = 0;
+        uint64_t size = 0;
+    };
+
+    struct FolderStats
+    {
+        std::filesystem::path path;
+        int depth = 0;                  // 0 for the scanned folder itself
+        uint64_t size = 0;              // Sum of the file sizes
+        uint64_t diskUsage = 0;         // Bytes actually allocated on disk, lower than size for sparse files. Same as size on Windows
+        uint64_t fileCount = 0;
+        uint64_t folderCount = 0;       // Sub-folders at any depth, not counting the folder itself
+        std::unordered_map<std::string, ExtensionStats> extensions;  // Keyed by extension including the dot, "" for files without one
+        std::array<uint64_t, AgeBucketCount> ageHistogram{};         // Number of files per age bucket
+    };
+
+    std::vector<FolderStats> folders;   // The scanned folder first, every folder before its sub-folders. Empty if the folder does not exist
+    uint64_t unreadableFolders = 0;     // Folders that could not be opened, e.g. missing permissions. Their content is not counted
+};